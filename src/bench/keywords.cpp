@@ -0,0 +1,97 @@
+// keyword recognition microbenchmark: the old if else wall against Keywords::lookup
+// build with -DFINN_BENCH=ON, or by hand: g++ -std=c++17 -O2 bench/keywords.cpp
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+
+#include "../lib/keywords.hpp"
+
+TokenType wall(std::string_view buffer) {
+    if      (buffer == "if")        return TokenType::IF;
+    else if (buffer == "else")      return TokenType::ELSE;
+    else if (buffer == "for")       return TokenType::FOR;
+    else if (buffer == "while")     return TokenType::WHILE;
+    else if (buffer == "func")      return TokenType::FUNC;
+    else if (buffer == "struct")    return TokenType::STRUCT;
+    else if (buffer == "enum")      return TokenType::ENUM;
+    else if (buffer == "class")     return TokenType::CLASS;
+    else if (buffer == "final")     return TokenType::FINAL;
+    else if (buffer == "interface") return TokenType::INTERFACE;
+    else if (buffer == "return")    return TokenType::RETURN;
+    else if (buffer == "throw")     return TokenType::THROW;
+    else if (buffer == "import")    return TokenType::IMPORT;
+    else if (buffer == "string")    return TokenType::STR;
+    else if (buffer == "int")       return TokenType::INT_TYPE;
+    else if (buffer == "i8")        return TokenType::INT8;
+    else if (buffer == "i16")       return TokenType::INT16;
+    else if (buffer == "i32")       return TokenType::INT32;
+    else if (buffer == "i64")       return TokenType::INT64;
+    else if (buffer == "i128")      return TokenType::INT128;
+    else if (buffer == "u8")        return TokenType::UINT8;
+    else if (buffer == "u16")       return TokenType::UINT16;
+    else if (buffer == "u32")       return TokenType::UINT32;
+    else if (buffer == "u64")       return TokenType::UINT64;
+    else if (buffer == "u128")      return TokenType::UINT128;
+    else if (buffer == "bool")      return TokenType::BOOL_TYPE;
+    else if (buffer == "float")     return TokenType::FLOAT_TYPE;
+    else if (buffer == "double")    return TokenType::DOUBLE_TYPE;
+    else if (buffer == "nil")       return TokenType::NIL;
+    else if (buffer == "true")      return TokenType::TRUE;
+    else if (buffer == "false")     return TokenType::FALSE;
+    else if (buffer == "type")      return TokenType::TYPE;
+    else if (buffer == "let")       return TokenType::LET;
+    else if (buffer == "const")     return TokenType::CONST;
+    else if (buffer == "static")    return TokenType::STATIC;
+    else                            return TokenType::IDENT;
+}
+
+template <typename Function>
+double run(const char* name, const std::vector<std::string>& words, Function function) {
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < 20; round++)
+        for (const std::string& word : words)
+            checksum += function(word);
+
+    std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+    double per_word = time.count() / (words.size() * 20);
+
+    std::cout << name << ": " << per_word << "ns/word (checksum " << checksum << ")\n";
+    return per_word;
+}
+
+int main(void) {
+    // roughly what real code looks like, about a third keywords and the rest identifiers
+    std::vector<std::string> identifiers = {
+        "x", "i", "value", "index", "buffer", "println", "result", "count", "self", "node",
+        "interval", "integer", "format", "stream", "token_type", "length", "u8_buffer", "items"
+    };
+
+    std::mt19937 random(42);
+    std::vector<std::string> words = {};
+
+    for (int i = 0; i < 1000000; i++) {
+        if (random() % 3 == 0)
+            words.push_back(std::string(Keywords::list[random() % std::size(Keywords::list)].text));
+        else
+            words.push_back(identifiers[random() % identifiers.size()]);
+    }
+
+    for (const std::string& word : words) {
+        if (wall(word) != Keywords::lookup(word)) {
+            std::cout << "mismatch on \"" << word << "\"\n";
+            return 1;
+        }
+    }
+
+    double wall_time = run("if else wall", words, wall);
+    double hash_time = run("perfect hash", words, Keywords::lookup);
+
+    std::cout << "speedup: " << wall_time / hash_time << "x\n";
+    return 0;
+}
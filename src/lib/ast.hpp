@@ -0,0 +1,441 @@
+#ifndef AST_HPP
+#define AST_HPP
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <initializer_list>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include "token.hpp"
+#include "span.hpp"
+#include "intern.hpp"
+#include "literal.hpp"
+#include "operators.hpp"
+
+typedef uint32_t NodeId;
+
+constexpr NodeId NO_NODE = UINT32_MAX;
+
+enum class NodeKind : uint8_t {
+    // expressions
+    BINARY,
+    SUFFIX,
+    PREFIX,
+    SCOPE,
+    CALL,
+    GROUPING,
+    NIL,
+    FLOAT_LIT,
+    INT_LIT,
+    BOOL_LIT,
+    STRING_LIT,
+    TYPE,
+    VARIABLE,
+    REASSIGN,
+
+    // statements
+    EXPRESSION,
+    MUTABLE,
+    CONSTANT,
+    IF,
+    WHILE,
+    BLOCK,
+    C_FOR,
+    FINN_FOR,
+    INTERFACE,
+    ENUM,
+    FUNC,
+    THROW,
+    RETURN,
+    STRUCT,
+    IMPORT,
+
+    // a function body that was skipped over and hasn't been parsed yet
+    LAZY_BODY,
+};
+
+// every node is 16 bytes, what the two slots hold depends on the kind. a list
+// is an index into `extra` holding the count and then the items, and nodes
+// with more than two children keep them in `extra` too
+//
+//   BINARY      op, first = left, second = right
+//   SUFFIX      op, first = left
+//   PREFIX      op, first = right
+//   SCOPE       first = root, second = member
+//   CALL        first = callee, second = list of args
+//   GROUPING    first = expression
+//   FLOAT_LIT   first = index into floats
+//   INT_LIT     first = index into integers
+//   BOOL_LIT    first = 0 or 1
+//   STRING_LIT  text = value
+//   TYPE        op, text = spelling
+//   VARIABLE    text = name
+//   REASSIGN    first = name, second = value
+//   EXPRESSION  first = expression
+//   MUTABLE     text = name, first = list of types, second = value or NO_NODE
+//   CONSTANT    text = name, first = list of types, second = value
+//   IF          first = condition, second = extra [then, else or NO_NODE]
+//   WHILE       first = condition, second = body
+//   BLOCK       first = list of statements
+//   C_FOR       first = extra [variable, condition, iterable, body]
+//   FINN_FOR    first = extra [name, list of types, iterator, body]
+//   INTERFACE   text = name, first = list of statements
+//   ENUM        text = name, first = list of types, second = list of members
+//   FUNC        first = name, second = extra [list of args, list of return types, list of throw types, body]
+//   THROW       first = value
+//   RETURN      first = value
+//   STRUCT      text = name, first = list of members
+//   IMPORT      first = module
+//   LAZY_BODY   first = index of the token after the '{', second = index of the matching '}'
+struct Node {
+    NodeKind kind;
+    uint8_t  op;
+    uint16_t padding;
+    SymbolId text;
+    uint32_t first;
+    uint32_t second;
+
+    TokenType token_type(void) const { return static_cast<TokenType>(this->op); }
+};
+
+static_assert(sizeof(Node) == 16, "nodes are meant to pack four to a cache line");
+
+// the whole AST of a compilation unit in one pool, children are 32 bit indices
+// into it. walks switch on the node kind instead of going through a vtable.
+// every node also gets the SourceLoc of its main token (the operator, the
+// keyword, the name...) in `locs`, kept apart from `nodes` since only
+// diagnostics ever look at it. nodes the parser makes up rather than reads,
+// like the nil in `let x;`, have no location
+class Ast {
+    uint32_t file_id;
+
+    std::vector<Node>             nodes;
+    std::vector<SourceLoc>        locs;
+    std::vector<uint32_t>         extra = {0}; // extra[0] is the shared empty list
+    std::vector<Literal::uint128> integers;
+    std::vector<double>           floats;
+
+    NodeId add(SourceLoc loc, NodeKind kind, uint32_t first = NO_NODE, uint32_t second = NO_NODE, SymbolId text = 0, TokenType op = TokenType::END_OF_FILE) {
+        this->nodes.push_back(Node{kind, static_cast<uint8_t>(op), 0, text, first, second});
+        this->locs.push_back(loc);
+        return this->nodes.size() - 1;
+    }
+
+    uint32_t add_extra(std::initializer_list<uint32_t> values) {
+        uint32_t index = this->extra.size();
+        this->extra.insert(this->extra.end(), values);
+        return index;
+    }
+
+    public:
+        static constexpr uint32_t EMPTY_LIST = 0;
+
+        explicit Ast(uint32_t file_id = 0) : file_id(file_id) {}
+
+        // nearly every node takes at least one token, so the token count is a good
+        // upper bound. it's only address space until the parser gets there
+        void reserve(size_t tokens) {
+            this->nodes.reserve(tokens);
+            this->locs.reserve(tokens);
+            this->extra.reserve(tokens / 2);
+        }
+
+        const Node& get(NodeId id) const { return this->nodes[id]; }
+
+        SourceLoc loc(NodeId id) const { return this->locs[id]; }
+
+        uint32_t get_file_id(void) const { return this->file_id; }
+
+        size_t size(void) const { return this->nodes.size(); }
+
+        size_t bytes(void) const {
+            return this->nodes.size() * (sizeof(Node) + sizeof(SourceLoc)) + this->extra.size() * sizeof(uint32_t)
+                 + this->integers.size() * sizeof(Literal::uint128) + this->floats.size() * sizeof(double);
+        }
+
+        Span<const NodeId> list(uint32_t index) const {
+            return Span<const NodeId>(this->extra.data() + index + 1, this->extra[index]);
+        }
+
+        const uint32_t* extra_data(uint32_t index) const { return this->extra.data() + index; }
+
+        // the raw pools, for AstWriter::binary
+        const std::vector<Node>&             node_pool(void) const { return this->nodes; }
+        const std::vector<SourceLoc>&        loc_pool(void) const { return this->locs; }
+        const std::vector<uint32_t>&         extra_pool(void) const { return this->extra; }
+        const std::vector<Literal::uint128>& integer_pool(void) const { return this->integers; }
+        const std::vector<double>&           float_pool(void) const { return this->floats; }
+
+        Literal::uint128 integer(const Node& node) const { return this->integers[node.first]; }
+        double floating(const Node& node) const { return this->floats[node.first]; }
+
+        uint32_t add_list(const NodeId* items, size_t count) {
+            if (count == 0)
+                return EMPTY_LIST;
+
+            uint32_t index = this->extra.size();
+            this->extra.push_back(count);
+            this->extra.insert(this->extra.end(), items, items + count);
+            return index;
+        }
+
+        NodeId add_binary(SourceLoc loc, NodeId left, TokenType op, NodeId right) { return this->add(loc, NodeKind::BINARY, left, right, 0, op); }
+        NodeId add_suffix(SourceLoc loc, NodeId left, TokenType op) { return this->add(loc, NodeKind::SUFFIX, left, NO_NODE, 0, op); }
+        NodeId add_prefix(SourceLoc loc, NodeId right, TokenType op) { return this->add(loc, NodeKind::PREFIX, right, NO_NODE, 0, op); }
+        NodeId add_scope(SourceLoc loc, NodeId root, NodeId member) { return this->add(loc, NodeKind::SCOPE, root, member); }
+        NodeId add_call(SourceLoc loc, NodeId callee, uint32_t args) { return this->add(loc, NodeKind::CALL, callee, args); }
+        NodeId add_grouping(SourceLoc loc, NodeId expression) { return this->add(loc, NodeKind::GROUPING, expression); }
+        NodeId add_nil(SourceLoc loc) { return this->add(loc, NodeKind::NIL); }
+        NodeId add_bool(SourceLoc loc, bool value) { return this->add(loc, NodeKind::BOOL_LIT, value); }
+        NodeId add_string(SourceLoc loc, SymbolId value) { return this->add(loc, NodeKind::STRING_LIT, NO_NODE, NO_NODE, value); }
+        NodeId add_type(SourceLoc loc, SymbolId spelling, TokenType op) { return this->add(loc, NodeKind::TYPE, NO_NODE, NO_NODE, spelling, op); }
+        NodeId add_variable(SourceLoc loc, SymbolId name) { return this->add(loc, NodeKind::VARIABLE, NO_NODE, NO_NODE, name); }
+        NodeId add_reassign(SourceLoc loc, NodeId name, NodeId value) { return this->add(loc, NodeKind::REASSIGN, name, value); }
+
+        NodeId add_float(SourceLoc loc, double value) {
+            this->floats.push_back(value);
+            return this->add(loc, NodeKind::FLOAT_LIT, this->floats.size() - 1);
+        }
+
+        NodeId add_integer(SourceLoc loc, Literal::uint128 value) {
+            this->integers.push_back(value);
+            return this->add(loc, NodeKind::INT_LIT, this->integers.size() - 1);
+        }
+
+        // a number written the way the parser would, a prefix minus in front of a
+        // negative one, for passes that work values out ahead of time
+        NodeId add_number(SourceLoc loc, Literal::Number value) {
+            NodeId id = this->add_integer(loc, value.magnitude);
+            return value.negative ? this->add_prefix(loc, id, TokenType::MINUS) : id;
+        }
+
+        NodeId add_number(SourceLoc loc, double value) {
+            NodeId id = this->add_float(loc, std::fabs(value));
+            return std::signbit(value) ? this->add_prefix(loc, id, TokenType::MINUS) : id;
+        }
+
+        NodeId add_expression(SourceLoc loc, NodeId expression) { return this->add(loc, NodeKind::EXPRESSION, expression); }
+        NodeId add_mutable(SourceLoc loc, SymbolId name, uint32_t types, NodeId value) { return this->add(loc, NodeKind::MUTABLE, types, value, name); }
+        NodeId add_constant(SourceLoc loc, SymbolId name, uint32_t types, NodeId value) { return this->add(loc, NodeKind::CONSTANT, types, value, name); }
+        NodeId add_while(SourceLoc loc, NodeId condition, NodeId body) { return this->add(loc, NodeKind::WHILE, condition, body); }
+        NodeId add_block(SourceLoc loc, uint32_t statements) { return this->add(loc, NodeKind::BLOCK, statements); }
+        NodeId add_interface(SourceLoc loc, SymbolId name, uint32_t body) { return this->add(loc, NodeKind::INTERFACE, body, NO_NODE, name); }
+        NodeId add_enum(SourceLoc loc, SymbolId name, uint32_t types, uint32_t members) { return this->add(loc, NodeKind::ENUM, types, members, name); }
+        NodeId add_throw(SourceLoc loc, NodeId value) { return this->add(loc, NodeKind::THROW, value); }
+        NodeId add_return(SourceLoc loc, NodeId value) { return this->add(loc, NodeKind::RETURN, value); }
+        NodeId add_struct(SourceLoc loc, SymbolId name, uint32_t members) { return this->add(loc, NodeKind::STRUCT, members, NO_NODE, name); }
+        NodeId add_import(SourceLoc loc, NodeId module) { return this->add(loc, NodeKind::IMPORT, module); }
+        NodeId add_lazy_body(SourceLoc loc, uint32_t begin, uint32_t end) { return this->add(loc, NodeKind::LAZY_BODY, begin, end); }
+
+        NodeId add_if(SourceLoc loc, NodeId condition, NodeId then_branch, NodeId else_branch) {
+            return this->add(loc, NodeKind::IF, condition, this->add_extra({then_branch, else_branch}));
+        }
+
+        NodeId add_c_for(SourceLoc loc, NodeId variable, NodeId condition, NodeId iterable, NodeId body) {
+            return this->add(loc, NodeKind::C_FOR, this->add_extra({variable, condition, iterable, body}));
+        }
+
+        NodeId add_finn_for(SourceLoc loc, NodeId name, uint32_t types, NodeId iterator, NodeId body) {
+            return this->add(loc, NodeKind::FINN_FOR, this->add_extra({name, types, iterator, body}));
+        }
+
+        NodeId add_func(SourceLoc loc, NodeId name, uint32_t args, uint32_t return_types, uint32_t throw_types, NodeId body) {
+            return this->add(loc, NodeKind::FUNC, name, this->add_extra({args, return_types, throw_types, body}));
+        }
+
+        // swaps a function's body for another node, once a lazy one is parsed
+        void set_body(NodeId func, NodeId body) {
+            this->extra[this->nodes[func].second + 3] = body;
+        }
+
+        NodeId body(NodeId func) const {
+            return this->extra[this->nodes[func].second + 3];
+        }
+
+        // makes `id` a copy of `with`, location and all, so whatever pointed at
+        // `id` sees `with` from then on. for passes that rewrite the tree in place
+        void replace(NodeId id, NodeId with) {
+            this->nodes[id] = this->nodes[with];
+            this->locs[id] = this->locs[with];
+        }
+
+        // calls `visit` on every child of a node in source order, list items and
+        // the children kept in `extra` included. missing children are skipped
+        template<typename Visit>
+        void each_child(NodeId id, Visit visit) const {
+            const Node& node = this->nodes[id];
+
+            auto one = [&](NodeId child) {
+                if (child != NO_NODE)
+                    visit(child);
+            };
+
+            auto all = [&](uint32_t list) {
+                for (NodeId item : this->list(list))
+                    visit(item);
+            };
+
+            switch (node.kind) {
+
+                case NodeKind::BINARY:
+                case NodeKind::SCOPE:
+                case NodeKind::REASSIGN:
+                case NodeKind::WHILE: {
+                    one(node.first);
+                    one(node.second);
+                    break;
+                }
+
+                case NodeKind::SUFFIX:
+                case NodeKind::PREFIX:
+                case NodeKind::GROUPING:
+                case NodeKind::EXPRESSION:
+                case NodeKind::THROW:
+                case NodeKind::RETURN:
+                case NodeKind::IMPORT: {
+                    one(node.first);
+                    break;
+                }
+
+                case NodeKind::CALL: {
+                    one(node.first);
+                    all(node.second);
+                    break;
+                }
+
+                case NodeKind::MUTABLE:
+                case NodeKind::CONSTANT: {
+                    all(node.first);
+                    one(node.second);
+                    break;
+                }
+
+                case NodeKind::IF: {
+                    const uint32_t* branches = this->extra_data(node.second);
+                    one(node.first);
+                    one(branches[0]);
+                    one(branches[1]);
+                    break;
+                }
+
+                case NodeKind::BLOCK:
+                case NodeKind::INTERFACE:
+                case NodeKind::STRUCT: {
+                    all(node.first);
+                    break;
+                }
+
+                case NodeKind::C_FOR: {
+                    const uint32_t* parts = this->extra_data(node.first);
+                    for (int i = 0; i < 4; i++)
+                        one(parts[i]);
+                    break;
+                }
+
+                case NodeKind::FINN_FOR: {
+                    const uint32_t* parts = this->extra_data(node.first);
+                    one(parts[0]);
+                    all(parts[1]);
+                    one(parts[2]);
+                    one(parts[3]);
+                    break;
+                }
+
+                case NodeKind::ENUM: {
+                    all(node.first);
+                    all(node.second);
+                    break;
+                }
+
+                case NodeKind::FUNC: {
+                    const uint32_t* parts = this->extra_data(node.second);
+                    one(node.first);
+                    all(parts[0]);
+                    all(parts[1]);
+                    all(parts[2]);
+                    one(parts[3]);
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+
+            }
+        }
+
+        // the number type a list of annotations is, Literal::NO_TYPE unless it's
+        // exactly one
+        uint8_t number_type(uint32_t types) const {
+            Span<const NodeId> list = this->list(types);
+
+            if (list.size() != 1 || this->nodes[list[0]].kind != NodeKind::TYPE)
+                return Literal::NO_TYPE;
+
+            return Literal::width_of(this->nodes[list[0]].token_type()).bits == 0 ? Literal::NO_TYPE : this->nodes[list[0]].op;
+        }
+
+        // calls `visit` on the children of a node that are worked out in the same
+        // number type it is: what's in parentheses, both sides of arithmetic and
+        // what a minus negates
+        template<typename Visit>
+        void each_in_type(NodeId id, Visit visit) const {
+            const Node& node = this->nodes[id];
+
+            if (node.kind == NodeKind::BINARY && Literal::arithmetic(node.token_type())) {
+                visit(node.first);
+                visit(node.second);
+            } else if (node.kind == NodeKind::GROUPING || (node.kind == NodeKind::PREFIX && node.token_type() == TokenType::MINUS)) {
+                visit(node.first);
+            }
+        }
+
+        // depth first walk over everything under `root`, on a stack of its own
+        // rather than the native one so any nesting depth is fine. `enter` runs on
+        // the way down and can return false to skip a node's children, `leave`
+        // runs once they're all done and is told how many there were
+        template<typename Enter, typename Leave>
+        void walk(NodeId root, Enter enter, Leave leave) const {
+            constexpr uint32_t PENDING = UINT32_MAX;
+
+            struct Step {
+                NodeId   id;
+                uint32_t children;
+            };
+
+            std::vector<Step> stack = {{root, PENDING}};
+
+            while (!stack.empty()) {
+                size_t top = stack.size() - 1;
+                Step step = stack[top];
+
+                if (step.children != PENDING) {
+                    stack.pop_back();
+                    leave(step.id, step.children);
+                    continue;
+                }
+
+                if (!enter(step.id)) {
+                    stack.pop_back();
+                    continue;
+                }
+
+                this->each_child(step.id, [&](NodeId child) { stack.push_back(Step{child, PENDING}); });
+
+                stack[top].children = stack.size() - top - 1;
+                std::reverse(stack.begin() + top + 1, stack.end());
+            }
+        }
+
+        template<typename Enter>
+        void walk(NodeId root, Enter enter) const {
+            this->walk(root, enter, [](NodeId, uint32_t) {});
+        }
+};
+
+#endif
\ No newline at end of file
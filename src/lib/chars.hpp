@@ -0,0 +1,59 @@
+#ifndef CHARS_HPP
+#define CHARS_HPP
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// 256 entry character class table built at compile time, so the lexer never
+// calls into the locale dependent <cctype> functions
+namespace Chars {
+
+enum Class : uint8_t {
+    ALPHA       = 1 << 0,
+    DIGIT       = 1 << 1,
+    HEX         = 1 << 2,
+    IDENT_START = 1 << 3,
+    IDENT       = 1 << 4,
+    SPACE       = 1 << 5,
+    OPERATOR    = 1 << 6,
+};
+
+// every character that can start an operator, the operators themselves live in operators.hpp
+constexpr char operator_characters[] = ".+-@/*<>=&;:#,|!?(){}[]";
+
+constexpr std::array<uint8_t, 256> build_table(void) {
+    std::array<uint8_t, 256> table = {};
+
+    for (int character = 0; character < 256; character++) {
+        uint8_t classes = 0;
+
+        bool alpha = (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z');
+        bool digit = character >= '0' && character <= '9';
+
+        if (alpha) classes |= ALPHA;
+        if (digit) classes |= DIGIT;
+        if (digit || (character >= 'a' && character <= 'f') || (character >= 'A' && character <= 'F')) classes |= HEX;
+        if (alpha || character == '_') classes |= IDENT_START;
+        if (alpha || digit || character == '_') classes |= IDENT;
+        if (character == ' ' || character == '\t' || character == '\r' || character == '\n') classes |= SPACE;
+
+        table[character] = classes;
+    }
+
+    for (const char* character = operator_characters; *character != '\0'; character++)
+        table[static_cast<uint8_t>(*character)] |= OPERATOR;
+
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> table = build_table();
+
+inline bool is(char character, uint8_t classes) {
+    return (table[static_cast<uint8_t>(character)] & classes) != 0;
+}
+
+}
+
+#endif
@@ -15,20 +15,63 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
 
-#include "expr.hpp"
+#include <unordered_map>
+#include <vector>
 
-class Compiler {
+#include "intern.hpp"
+#include "ast.hpp"
+#include "visitor.hpp"
 
-    //std::vector<std::shared_ptr<Stmt::Stmt>> statements;
+class Compiler : public Visitor<Compiler, llvm::Value*> {
+
+    //std::vector<NodeId> statements;
 
     public:
-        static std::unique_ptr<llvm::LLVMContext>  context;
-        static std::unique_ptr<llvm::IRBuilder<>>  builder;
-        static std::unique_ptr<llvm::Module>       module;
-        static std::map<std::string, llvm::Value*> named_values;
+        static std::unique_ptr<llvm::LLVMContext>         context;
+        static std::unique_ptr<llvm::IRBuilder<>>         builder;
+        static std::unique_ptr<llvm::Module>              module;
+        static std::unordered_map<SymbolId, llvm::Value*> named_values;
         
-        //Compiler(std::vector<std::shared_ptr<Stmt::Stmt>> statements);
+        //Compiler(const Ast& ast, std::vector<NodeId> statements);
+
+        // lowers the tree under `root` bottom up without recursing. every node
+        // leaves one value behind on `values` (nullptr when it doesn't lower to
+        // anything yet), and its children's values are right under it
+        llvm::Value* codegen(const Ast& ast, NodeId root) {
+            std::vector<llvm::Value*> values;
+
+            ast.walk(root, [](NodeId) { return true; }, [&](NodeId id, uint32_t children) {
+                llvm::Value* value = this->visit(ast, id, values.data() + values.size() - children);
+                values.resize(values.size() - children);
+                values.push_back(value);
+            });
+
+            return values.back();
+        }
+
+        // the children's values come in through `operands`, in source order
+        llvm::Value* visit_binary(NodeId, const Node& node, llvm::Value* const* operands) {
+            llvm::Value* left_value = operands[0];
+            llvm::Value* right_value = operands[1];
+
+            if (!(left_value || right_value))
+                return nullptr;
+
+            switch (node.token_type()) {
+
+                case TokenType::PLUS: {
+                    break;
+                    //return this->builder->CreateFAdd(left_value, right_value, "addtmp");
+                }
+
+                default: {
+                    break;
+                }
+
+            }
 
+            return nullptr;
+        }
 };
 
 #endif
@@ -5,58 +5,155 @@
 
 #include <vector>
 #include <string>
-#include <memory>
-#include <cctype>
-#include <iostream>
+#include <string_view>
+#include <algorithm>
 
 #include "token.hpp"
+#include "ast.hpp"
+#include "source.hpp"
+#include "output.hpp"
+
+// where a diagnostic points: a token from the lexer or parser, or the SourceLoc
+// of an AST node from the passes after them. offsets stay 64 bit so lexer and
+// parser errors past 4GB still get a position
+struct Place {
+    static constexpr size_t NONE = SIZE_MAX;
+
+    uint32_t file_id;
+    size_t   offset;
+    size_t   length;
+
+    static Place of(const Token& token) {
+        return Place{token.file_id, token.offset, token.lexeme.length()};
+    }
+
+    static Place of(uint32_t file_id, SourceRange range) {
+        return Place{file_id, range.begin.valid() ? range.begin.offset : NONE, range.length};
+    }
+};
 
+// a problem somewhere in a file. nothing about it is worked out until it's
+// rendered, the line and column come from the file's line table and the source
+// line is sliced straight out of the file
 class Error {
-    std::string              message;
-    std::shared_ptr<Token>   token;
-    std::vector<std::string> lines;
+    std::string message;
+    Place       place;
+
+    public:
+        Error(std::string message, Place place)
+          : message(std::move(message)), place(place) {}
+
+        Error(std::string message, Token token)
+          : Error(std::move(message), Place::of(token)) {}
+
+        void print(void) const {
+            Output out(stdout);
+            this->render(out);
+        }
+
+        //   name:line:column: message
+        //    line | the source line
+        //         |     ^^^^
+        void render(Output& out) const {
+            const SourceFile& file = SourceManager::get(this->place.file_id);
+
+            // somewhere the location couldn't be kept, only the file is known
+            if (this->place.offset == Place::NONE) {
+                out.write(file.get_name()); out.write(": ");
+                out.write(this->message); out.put('\n');
+                return;
+            }
+
+            size_t line = file.line_of(this->place.offset);
+            size_t column = file.column_of(this->place.offset);
+            std::string_view text = file.line_text(line);
+
+            // a token running onto later lines is only underlined up to the end of this one
+            size_t width = std::min<size_t>(this->place.length, text.length() >= column ? text.length() - column + 1 : 0);
+            size_t gutter = std::to_string(line).length() + 2;
+
+            out.write(file.get_name()); out.put(':');
+            out.number(static_cast<uint64_t>(line)); out.put(':');
+            out.number(static_cast<uint64_t>(column)); out.write(": ");
+            out.write(this->message); out.put('\n');
+
+            out.put(' '); out.number(static_cast<uint64_t>(line)); out.write(" | ");
+            out.write(text); out.put('\n');
+
+            out.spaces(gutter); out.write("| ");
+            out.spaces(column - 1);
+            for (size_t i = 0; i < std::max<size_t>(width, 1); i++)
+                out.put('^');
+            out.put('\n');
+        }
+};
+
+struct Diagnostic {
+    std::string message;
+    Place       place;
+};
+
+// everything that went wrong in a run, so it can all be reported at once instead
+// of stopping at the first problem. only the first `limit` are kept, anything
+// past that is just counted
+class Diagnostics {
+    std::vector<Diagnostic> kept;
 
-    std::string output = "";
+    size_t limit;
+    size_t total = 0;
 
     public:
-        Error(std::string message, std::vector<std::string> lines, std::shared_ptr<Token> token)
-          : message(message), lines(lines), token(std::move(token)) {}
+        static constexpr size_t DEFAULT_LIMIT = 20;
 
-        ~Error() = default;
+        explicit Diagnostics(size_t limit = DEFAULT_LIMIT) : limit(limit) {}
 
-        void print(void) {
-            std::cout << this->build_error();
+        void report(std::string message, Place place) {
+            this->total++;
+            if (this->kept.size() < this->limit)
+                this->kept.push_back(Diagnostic{std::move(message), place});
+        }
+
+        void report(std::string message, Token token) {
+            this->report(std::move(message), Place::of(token));
+        }
 
+        // for the passes after parsing, which only have the node's SourceLoc
+        void report(std::string message, const Ast& ast, NodeId id, uint32_t length = 1) {
+            this->report(std::move(message), Place::of(ast.get_file_id(), SourceRange{ast.loc(id), length}));
         }
 
-    private:
-        std::string add_whitespace(std::string output, int indent) {
-            for (int i = 1; i <= indent; i++)
-                output += " ";
-            return output;
+        // takes over everything another one collected, eg. from a lexer chunk
+        void append(const Diagnostics& other) {
+            for (const Diagnostic& diagnostic : other.kept)
+                this->report(diagnostic.message, diagnostic.place);
+
+            this->total += other.total - other.kept.size();
         }
 
-        std::string build_error(void) {
-            std::string output = "";
-            std::cout << this->token->position.offset[0] << " " << this->token->position.offset[1] << "\n";
-            output += this->token->filename + ":" + std::to_string(this->token->position.line) + ":" + std::to_string(this->token->position.offset[1]) + ":\n";
-            std::cout << this->lines[this->token->position.line];
-            output += " " + std::to_string(this->token->position.line) + " | " + this->lines[this->token->position.line - 1];
+        bool empty(void) const { return this->total == 0; }
+        bool full(void) const { return this->total >= this->limit; }
+
+        size_t size(void) const { return this->total; }
+        size_t get_limit(void) const { return this->limit; }
+
+        // in the order they appear in the source, not the order they were found in,
+        // all through one buffer
+        void print(void) {
+            std::stable_sort(this->kept.begin(), this->kept.end(), [](const Diagnostic& a, const Diagnostic& b) {
+                return a.place.file_id != b.place.file_id ? a.place.file_id < b.place.file_id : a.place.offset < b.place.offset;
+            });
 
-            output = this->add_whitespace(output, std::to_string(this->token->position.line).length() + 2); 
-            output += "|";
-            output = this->add_whitespace(output, this->token->position.offset[0]);
+            Output out(stdout);
 
-            for (int i = this->token->position.offset[0]; i == this->token->position.offset[1]; i++)
-                output += "^";
-            output += "\n";
+            for (const Diagnostic& diagnostic : this->kept)
+                Error(diagnostic.message, diagnostic.place).render(out);
 
-            output = this->add_whitespace(output, std::to_string(this->token->position.line).length() + 2); 
-            this->output += "|";
-            output = this->add_whitespace(output, std::to_string(this->token->position.offset[0]).length());
+            if (this->total > this->kept.size()) {
+                out.write("... "); out.number(static_cast<uint64_t>(this->total - this->kept.size())); out.write(" more not shown\n");
+            }
 
-            output += this->message + "\n";
-            return output;
+            out.number(static_cast<uint64_t>(this->total));
+            out.write(this->total == 1 ? " error\n" : " errors\n");
         }
 };
 
@@ -0,0 +1,866 @@
+#ifndef EVAL_HPP
+#define EVAL_HPP
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <cmath>
+
+#include "ast.hpp"
+#include "visitor.hpp"
+#include "literal.hpp"
+#include "errors.hpp"
+#include "sema.hpp"
+
+// a value while compiling. NONE is only ever the lack of one
+struct EvalValue {
+    enum Kind : uint8_t { NIL, INTEGER, FLOATING, BOOLEAN, STRING, FUNCTION, RANGE, NONE };
+
+    Kind            kind     = NIL;
+    uint32_t        id       = 0; // the string, the FUNC node, or 0 and 1 for bools
+    double          floating = 0;
+    Literal::int128 integer  = 0; // and where a range starts
+    Literal::int128 end      = 0; // where a range stops
+
+    std::shared_ptr<const std::string> text = nullptr; // a string made while evaluating, `id` isn't used then
+};
+
+// runs ordinary Finn code while compiling. every const initializer is tried, and
+// when it only needs literals, other consts and calls to functions that don't
+// touch anything outside themselves it's swapped for the literal it comes out to.
+// `#expr` works the same anywhere but has to come out to something, and it's
+// an error when it doesn't. names are looked up through the SemaAnalyser's
+// resolutions, so it runs after sema.
+//
+// each evaluation gets its own budget of steps (one per statement and one per
+// expression node) and memory, so a loop that never ends is an error rather
+// than a hang. expressions are evaluated on the Ast's own walk, only calls
+// recurse and those are capped at MAX_DEPTH deep
+class CompileTimeEvaluator : public Visitor<CompileTimeEvaluator, EvalValue> {
+    public:
+        static constexpr size_t DEFAULT_STEPS  = 10000000;
+        static constexpr size_t DEFAULT_MEMORY = 64; // MB
+        static constexpr size_t MAX_DEPTH      = 1000;
+
+    private:
+        typedef EvalValue Value;
+
+        static constexpr Literal::int128 SMALLEST = -static_cast<Literal::int128>(~static_cast<Literal::uint128>(0) >> 1) - 1;
+
+        // thrown out of an evaluation that can't finish. without a message the
+        // code is fine, it just can't be known while compiling. `at` is NO_NODE
+        // when it's the whole evaluation that went wrong
+        struct Abandon {
+            NodeId      at;
+            std::string message;
+        };
+
+        enum class Flow : uint8_t {
+            NEXT,
+            RETURN,
+        };
+
+        Ast&                ast;
+        const SemaAnalyser& sema;
+        Diagnostics&        diagnostics;
+
+        size_t step_limit;
+        size_t memory_limit;
+
+        std::unordered_map<NodeId, NodeId> funcs; // name node to FUNC
+
+        // the bytes in strings made by this evaluation that are still held on to.
+        // they only go into the Interner if they end up in a literal, so one built
+        // up a piece at a time lets go of the pieces. above the bindings so it's
+        // still there when they let go for the last time
+        size_t strings = 0;
+
+        struct Made {
+            std::string text;
+            size_t&     live;
+
+            Made(std::string text, size_t& live) : text(std::move(text)), live(live) { live += this->text.length(); }
+            ~Made() { live -= this->text.length(); }
+        };
+
+        // the value of every declaration in reach, keyed by the declaring node.
+        // a call logs what its arguments and locals hide and rolls the log back
+        // on the way out, like Scopes does for names
+        struct Binding {
+            Value    value;
+            uint32_t depth;
+        };
+
+        struct Undo {
+            NodeId  decl;
+            bool    had;
+            Binding old;
+        };
+
+        std::unordered_map<NodeId, Binding> bindings;
+        std::vector<Undo>                   log;
+
+        Value returned;
+
+        // the number type each node's value is worked out in, NO_TYPE when there
+        // isn't one. handed down from the annotation a value is stored under
+        // through the arithmetic in it, like ConstantFolder does
+        std::vector<uint8_t> widths;
+        uint8_t              returns = Literal::NO_TYPE; // the return type of the call being run
+
+        uint32_t depth = 0;
+        size_t   steps = 0;
+
+        size_t evaluated   = 0;
+        size_t total_steps = 0;
+
+        static Literal::uint128 magnitude(Literal::int128 value) {
+            return value < 0 ? -static_cast<Literal::uint128>(value) : static_cast<Literal::uint128>(value);
+        }
+
+        static std::string_view text(const Value& value) {
+            return value.text ? std::string_view(*value.text) : Interner::text(value.id);
+        }
+
+        // a string that outlives the evaluation goes into the Interner
+        static void keep(Value& value) {
+            if (value.text) {
+                value.id = Interner::intern_copy(*value.text);
+                value.text.reset();
+            }
+        }
+
+        [[noreturn]] static void unknown(NodeId at) {
+            throw Abandon{at, ""};
+        }
+
+        [[noreturn]] static void fail(NodeId at, std::string message) {
+            throw Abandon{at, std::move(message)};
+        }
+
+        void step(void) {
+            if (++this->steps > this->step_limit)
+                fail(NO_NODE, "Compile-time evaluation took more than " + std::to_string(this->step_limit) + " steps");
+        }
+
+        // roughly what the bindings and the strings still held take up
+        void charge(void) {
+            size_t bytes = this->bindings.size() * (sizeof(NodeId) + sizeof(Binding) + 2 * sizeof(void*))
+                         + this->log.size() * sizeof(Undo)
+                         + this->strings;
+
+            if (bytes > this->memory_limit * 1024 * 1024)
+                fail(NO_NODE, "Compile-time evaluation needed more than " + std::to_string(this->memory_limit) + "MB");
+        }
+
+        void bind(NodeId decl, const Value& value) {
+            auto found = this->bindings.find(decl);
+
+            // a let in a loop is bound over and over at the same depth, only the
+            // first time hides anything
+            if (found != this->bindings.end() && found->second.depth == this->depth) {
+                found->second.value = value;
+                return;
+            }
+
+            if (found != this->bindings.end()) {
+                this->log.push_back(Undo{decl, true, found->second});
+                found->second = Binding{value, this->depth};
+            } else {
+                this->log.push_back(Undo{decl, false, Binding{}});
+                this->bindings.emplace(decl, Binding{value, this->depth});
+            }
+
+            this->charge();
+        }
+
+        void rollback(size_t mark) {
+            while (this->log.size() > mark) {
+                const Undo& undo = this->log.back();
+
+                if (undo.had)
+                    this->bindings[undo.decl] = undo.old;
+                else
+                    this->bindings.erase(undo.decl);
+
+                this->log.pop_back();
+            }
+        }
+
+        uint8_t annotation(NodeId id) const {
+            return id < this->widths.size() ? this->widths[id] : Literal::NO_TYPE;
+        }
+
+        Literal::Width width(NodeId id) const {
+            return Literal::width_of_annotation(this->annotation(id));
+        }
+
+        void hand(NodeId id, uint8_t annotation) {
+            if (id == NO_NODE)
+                return;
+
+            if (id >= this->widths.size())
+                this->widths.resize(this->ast.size(), Literal::NO_TYPE);
+
+            this->widths[id] = annotation;
+        }
+
+        // passes a node's type on to the children that are worked out in it, like
+        // ConstantFolder does, and gives arguments and reassigned values the type
+        // they're stored as
+        void hand_down(NodeId id) {
+            const Node& node = this->ast.get(id);
+            uint8_t annotation = this->annotation(id);
+
+            this->ast.each_in_type(id, [&](NodeId child) { this->hand(child, annotation); });
+
+            switch (node.kind) {
+
+                case NodeKind::REASSIGN: {
+                    NodeId decl = this->ast.get(node.first).kind == NodeKind::VARIABLE ? this->sema.resolution(node.first) : NO_NODE;
+
+                    if (decl != NO_NODE && decl != SemaAnalyser::BUILTIN && this->ast.get(decl).kind == NodeKind::MUTABLE)
+                        this->hand(node.second, this->ast.number_type(this->ast.get(decl).first));
+                    break;
+                }
+
+                case NodeKind::CALL: {
+                    NodeId decl = this->ast.get(node.first).kind == NodeKind::VARIABLE ? this->sema.resolution(node.first) : NO_NODE;
+                    auto func = this->funcs.find(decl);
+
+                    if (func == this->funcs.end())
+                        break;
+
+                    Span<const NodeId> args = this->ast.list(node.second);
+                    Span<const NodeId> params = this->ast.list(this->ast.extra_data(this->ast.get(func->second).second)[0]);
+
+                    for (size_t i = 0; i < args.size() && i < params.size(); i++)
+                        this->hand(args[i], this->ast.number_type(this->ast.get(params[i]).first));
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+
+            }
+        }
+
+        // what storing `value` somewhere annotated with `types` makes of it
+        Value fit(Value value, uint32_t types, NodeId at) {
+            return this->narrow(value, Literal::width_of_annotation(this->ast.number_type(types)), at);
+        }
+
+        // unsigned integers wrap like they will at run time, signed ones have to fit
+        Value narrow(Value value, Literal::Width width, NodeId at) {
+            if (width.bits == 0)
+                return value;
+
+            if (width.floating) {
+                if (value.kind == EvalValue::FLOATING && width.bits == 32)
+                    value.floating = static_cast<float>(value.floating);
+                return value;
+            }
+
+            if (value.kind != EvalValue::INTEGER)
+                return value;
+
+            Literal::Number exact = number(value.integer);
+
+            if (Literal::narrow(exact.magnitude, exact.negative, width.bits, width.is_signed) && held(exact, value.integer))
+                return value;
+
+            fail(at, "Compile-time value doesn't fit in " + type_name(width));
+        }
+
+        static Literal::Number number(Literal::int128 value) {
+            return Literal::Number{magnitude(value), value < 0};
+        }
+
+        // a u128 past the top of i128 can't be held here
+        static bool held(Literal::Number number, Literal::int128& value) {
+            if (number.magnitude > magnitude(SMALLEST) - (number.negative ? 0 : 1))
+                return false;
+
+            value = number.negative ? -static_cast<Literal::int128>(number.magnitude - 1) - 1 : static_cast<Literal::int128>(number.magnitude);
+            return true;
+        }
+
+        static std::string type_name(Literal::Width width) {
+            return (width.is_signed ? "i" : "u") + std::to_string(width.bits);
+        }
+
+        static Value integer(Literal::int128 value) {
+            Value result{EvalValue::INTEGER};
+            result.integer = value;
+            return result;
+        }
+
+        static Value boolean(bool value) {
+            Value result{EvalValue::BOOLEAN};
+            result.id = value;
+            return result;
+        }
+
+        // one step in the integer type `width`, see Literal::step
+        Value arithmetic(NodeId id, TokenType op, Literal::int128 left, Literal::int128 right, Literal::Width width) {
+            Literal::Number result;
+            Value value = integer(0);
+
+            switch (Literal::step(op, number(left), number(right), width, result)) {
+                case Literal::Step::BY_ZERO: fail(id, "Division by zero at compile time");
+                case Literal::Step::UNKNOWN: unknown(id);
+
+                case Literal::Step::OUT_OF_RANGE: {
+                    if (width.bits != 0 && !width.floating)
+                        fail(id, "Compile-time value doesn't fit in " + type_name(width));
+                    break;
+                }
+
+                case Literal::Step::DONE: {
+                    if (held(result, value.integer))
+                        return value;
+                    break;
+                }
+            }
+
+            fail(id, "Integer overflow at compile time");
+        }
+
+        // runs an expression stored as `annotation`, on a stack of values of its own
+        Value evaluate(NodeId root, uint8_t annotation = Literal::NO_TYPE) {
+            std::vector<Value> stack;
+
+            this->hand(root, annotation);
+
+            this->ast.walk(root, [&](NodeId id) { this->step(); this->hand_down(id); return true; }, [&](NodeId id, uint32_t children) {
+                Value value = this->visit(this->ast, id, stack.data() + stack.size() - children, children);
+                stack.resize(stack.size() - children);
+                stack.push_back(value);
+            });
+
+            return stack.back();
+        }
+
+        Value call(NodeId id, const Value* operands, uint32_t given) {
+            if (operands[0].kind != EvalValue::FUNCTION)
+                unknown(this->ast.get(id).first);
+
+            NodeId func = operands[0].id;
+            const uint32_t* parts = this->ast.extra_data(this->ast.get(func).second);
+            Span<const NodeId> args = this->ast.list(parts[0]);
+
+            if (parts[3] == NO_NODE || this->ast.get(parts[3]).kind != NodeKind::BLOCK)
+                unknown(id);
+
+            std::string_view name = Interner::text(this->ast.get(this->ast.get(func).first).text);
+
+            if (given > args.size())
+                fail(id, "'" + std::string(name) + "' takes " + std::to_string(args.size()) + " arguments, not " + std::to_string(given));
+
+            // reported at whatever started the evaluation, like running out of steps
+            if (this->depth + 1 > MAX_DEPTH)
+                fail(NO_NODE, "Compile-time calls nest more than " + std::to_string(MAX_DEPTH) + " deep");
+
+            size_t mark = this->log.size();
+            uint8_t outer = this->returns;
+            this->depth++;
+
+            for (uint32_t i = 0; i < args.size(); i++) {
+                const Node& arg = this->ast.get(args[i]);
+                Value value;
+
+                if (i < given)
+                    value = operands[1 + i];
+                else if (arg.second != NO_NODE && this->ast.loc(arg.second).valid())
+                    value = this->evaluate(arg.second, this->ast.number_type(arg.first));
+                else
+                    fail(id, "Missing argument '" + std::string(Interner::text(arg.text)) + "' for '" + std::string(name) + "'");
+
+                this->bind(args[i], this->fit(value, arg.first, id));
+            }
+
+            Value result;
+            this->returns = this->ast.number_type(parts[1]);
+            if (this->execute(parts[3]) == Flow::RETURN)
+                result = this->returned;
+
+            result = this->fit(result, parts[1], id);
+
+            this->rollback(mark);
+            this->returns = outer;
+            this->depth--;
+            return result;
+        }
+
+        // the branch an if takes and the last statement in a block are run in its
+        // place rather than recursed into, so an else if chain or a block nested
+        // at the end of another one doesn't take up any native stack
+        Flow execute(NodeId id) {
+            while (true) {
+                const Node& node = this->ast.get(id);
+                this->step();
+
+                switch (node.kind) {
+
+                    case NodeKind::EXPRESSION: {
+                        this->evaluate(node.first);
+                        return Flow::NEXT;
+                    }
+
+                    case NodeKind::MUTABLE:
+                    case NodeKind::CONSTANT: {
+                        Value value = node.second == NO_NODE ? Value{} : this->evaluate(node.second, this->ast.number_type(node.first));
+                        this->bind(id, this->fit(value, node.first, id));
+                        return Flow::NEXT;
+                    }
+
+                    case NodeKind::BLOCK: {
+                        Span<const NodeId> statements = this->ast.list(node.first);
+
+                        if (statements.size() == 0)
+                            return Flow::NEXT;
+
+                        for (uint32_t i = 0; i + 1 < statements.size(); i++)
+                            if (this->execute(statements[i]) == Flow::RETURN)
+                                return Flow::RETURN;
+
+                        id = statements[statements.size() - 1];
+                        continue;
+                    }
+
+                    case NodeKind::IF: {
+                        const uint32_t* branches = this->ast.extra_data(node.second);
+                        NodeId branch = this->condition(node.first) ? branches[0] : branches[1];
+
+                        if (branch == NO_NODE)
+                            return Flow::NEXT;
+
+                        id = branch;
+                        continue;
+                    }
+
+                    case NodeKind::WHILE: {
+                        while (this->condition(node.first))
+                            if (this->execute(node.second) == Flow::RETURN)
+                                return Flow::RETURN;
+                        return Flow::NEXT;
+                    }
+
+                    case NodeKind::C_FOR: {
+                        const uint32_t* parts = this->ast.extra_data(node.first);
+
+                        if (parts[0] != NO_NODE)
+                            this->execute(parts[0]);
+
+                        while (parts[1] == NO_NODE || this->condition(parts[1])) {
+                            if (parts[3] != NO_NODE && this->execute(parts[3]) == Flow::RETURN)
+                                return Flow::RETURN;
+                            if (parts[2] != NO_NODE)
+                                this->evaluate(parts[2]);
+                        }
+                        return Flow::NEXT;
+                    }
+
+                    // ranges are half open, 0 .. 10 stops at 9
+                    case NodeKind::FINN_FOR: {
+                        const uint32_t* parts = this->ast.extra_data(node.first);
+
+                        if (parts[2] == NO_NODE)
+                            unknown(id);
+
+                        Value range = this->evaluate(parts[2]);
+
+                        if (range.kind != EvalValue::RANGE)
+                            unknown(parts[2]);
+
+                        for (Literal::int128 i = range.integer; i < range.end; i++) {
+                            this->bind(parts[0], integer(i));
+                            if (this->execute(parts[3]) == Flow::RETURN)
+                                return Flow::RETURN;
+                        }
+                        return Flow::NEXT;
+                    }
+
+                    case NodeKind::RETURN: {
+                        this->returned = node.first == NO_NODE ? Value{} : this->evaluate(node.first, this->returns);
+                        return Flow::RETURN;
+                    }
+
+                    // nothing to run, nested functions are found through their names
+                    case NodeKind::FUNC:
+                    case NodeKind::STRUCT:
+                    case NodeKind::ENUM:
+                    case NodeKind::INTERFACE:
+                    case NodeKind::IMPORT: {
+                        return Flow::NEXT;
+                    }
+
+                    default: {
+                        unknown(id);
+                    }
+
+                }
+            }
+        }
+
+        bool condition(NodeId id) {
+            Value value = this->evaluate(id);
+
+            if (value.kind != EvalValue::BOOLEAN)
+                unknown(id);
+
+            return value.id != 0;
+        }
+
+        // the literal a value is written as, a prefix minus in front of a negative number
+        NodeId literal(SourceLoc loc, Value value) {
+            switch (value.kind) {
+
+                case EvalValue::INTEGER:  return this->ast.add_number(loc, number(value.integer));
+                case EvalValue::FLOATING: return std::isfinite(value.floating) ? this->ast.add_number(loc, value.floating) : NO_NODE;
+                case EvalValue::BOOLEAN:  return this->ast.add_bool(loc, value.id != 0);
+                case EvalValue::STRING:   keep(value); return this->ast.add_string(loc, value.id);
+                case EvalValue::NIL:      return this->ast.add_nil(loc);
+                default:                  return NO_NODE;
+
+            }
+        }
+
+        bool is_literal(NodeId id) const {
+            const Node& node = this->ast.get(id);
+
+            if (node.kind == NodeKind::PREFIX && node.token_type() == TokenType::MINUS)
+                return this->is_literal(node.first);
+
+            return node.kind == NodeKind::INT_LIT || node.kind == NodeKind::FLOAT_LIT || node.kind == NodeKind::BOOL_LIT
+                || node.kind == NodeKind::STRING_LIT || node.kind == NodeKind::NIL;
+        }
+
+        // runs `root` from scratch with a fresh budget. false if it didn't come
+        // out to anything, which is reported when it was an error or `required`
+        bool run(NodeId root, uint8_t annotation, NodeId report_at, bool required, Value& result) {
+            this->steps = 0;
+            this->returned = Value{};
+
+            try {
+                result = this->evaluate(root, annotation);
+            } catch (const Abandon& abandon) {
+                this->rollback(0);
+                this->depth = 0;
+                this->returns = Literal::NO_TYPE;
+
+                NodeId at = abandon.at == NO_NODE ? report_at : abandon.at;
+
+                if (!abandon.message.empty())
+                    this->diagnostics.report(abandon.message, this->ast, at);
+                else if (required)
+                    this->diagnostics.report("Can't be evaluated at compile time", this->ast, at);
+            }
+
+            this->total_steps += this->steps;
+            return result.kind != EvalValue::NONE;
+        }
+
+        // a const that comes out to something stays bound for good, and its
+        // initializer becomes a literal if it wasn't one already
+        bool constant(NodeId id) {
+            Node node = this->ast.get(id);
+            Value value{EvalValue::NONE};
+
+            if (!this->run(node.second, this->ast.number_type(node.first), node.second, false, value))
+                return false;
+
+            try {
+                value = this->fit(value, node.first, node.second);
+            } catch (const Abandon& abandon) {
+                this->diagnostics.report(abandon.message, this->ast, abandon.at);
+                return false;
+            }
+
+            keep(value);
+            this->bindings[id] = Binding{value, 0};
+
+            if (!this->is_literal(node.second)) {
+                NodeId literal = this->literal(this->ast.loc(node.second), value);
+                if (literal != NO_NODE)
+                    this->ast.replace(node.second, literal);
+            }
+
+            this->evaluated++;
+            return true;
+        }
+
+        void directive(NodeId id) {
+            Value value{EvalValue::NONE};
+
+            if (!this->run(this->ast.get(id).first, Literal::NO_TYPE, id, true, value))
+                return;
+
+            NodeId literal = this->literal(this->ast.loc(id), value);
+
+            if (literal == NO_NODE) {
+                this->diagnostics.report("The result can't be written as a literal", this->ast, id);
+                return;
+            }
+
+            this->ast.replace(id, literal);
+            this->evaluated++;
+        }
+
+    public:
+        CompileTimeEvaluator(Ast& ast, const SemaAnalyser& sema, Diagnostics& diagnostics,
+                             size_t step_limit = DEFAULT_STEPS, size_t memory_limit = DEFAULT_MEMORY)
+          : ast(ast), sema(sema), diagnostics(diagnostics), step_limit(step_limit), memory_limit(memory_limit), widths(ast.size(), Literal::NO_TYPE) {
+            for (NodeId id = 0; id < ast.size(); id++)
+                if (ast.get(id).kind == NodeKind::FUNC)
+                    this->funcs[ast.get(id).first] = id;
+        }
+
+        // in source order, so a const can use the ones before it
+        void evaluate_all(const std::vector<NodeId>& statements) {
+            for (NodeId statement : statements) {
+                this->ast.walk(statement, [&](NodeId id) {
+                    const Node& node = this->ast.get(id);
+
+                    if (node.kind == NodeKind::CONSTANT && node.second != NO_NODE)
+                        return !this->constant(id);
+
+                    if (node.kind == NodeKind::PREFIX && node.token_type() == TokenType::HASH) {
+                        this->directive(id);
+                        return false;
+                    }
+
+                    return node.kind != NodeKind::LAZY_BODY;
+                });
+            }
+        }
+
+        size_t evaluated_count(void) const { return this->evaluated; }
+        size_t step_count(void) const { return this->total_steps; }
+
+        // the visit_ methods run on the way out of each node, the children's
+        // values come in through `operands` in source order
+        Value visit_node(NodeId id, const Node&, const Value*, uint32_t) {
+            unknown(id);
+        }
+
+        Value visit_integer(NodeId id, const Node& node, const Value*, uint32_t) {
+            Literal::uint128 value = this->ast.integer(node);
+
+            if (value > static_cast<Literal::uint128>(~static_cast<Literal::uint128>(0) >> 1))
+                unknown(id);
+
+            return integer(static_cast<Literal::int128>(value));
+        }
+
+        Value visit_float(NodeId, const Node& node, const Value*, uint32_t) {
+            Value value{EvalValue::FLOATING};
+            value.floating = this->ast.floating(node);
+            return value;
+        }
+
+        Value visit_bool(NodeId, const Node& node, const Value*, uint32_t) {
+            return boolean(node.first != 0);
+        }
+
+        Value visit_string(NodeId, const Node& node, const Value*, uint32_t) {
+            Value value{EvalValue::STRING};
+            value.id = node.text;
+            return value;
+        }
+
+        Value visit_nil(NodeId, const Node&, const Value*, uint32_t) {
+            return Value{};
+        }
+
+        Value visit_grouping(NodeId, const Node&, const Value* operands, uint32_t) {
+            return operands[0];
+        }
+
+        Value visit_variable(NodeId id, const Node&, const Value*, uint32_t) {
+            NodeId decl = this->sema.resolution(id);
+
+            if (decl == NO_NODE || decl == SemaAnalyser::BUILTIN)
+                unknown(id);
+
+            auto func = this->funcs.find(decl);
+            if (func != this->funcs.end()) {
+                Value value{EvalValue::FUNCTION};
+                value.id = func->second;
+                return value;
+            }
+
+            auto found = this->bindings.find(decl);
+            if (found == this->bindings.end())
+                unknown(id);
+
+            return found->second.value;
+        }
+
+        Value visit_prefix(NodeId id, const Node& node, const Value* operands, uint32_t) {
+            Value value = operands[0];
+
+            switch (node.token_type()) {
+
+                case TokenType::HASH: {
+                    return value;
+                }
+
+                case TokenType::MINUS: {
+                    if (value.kind == EvalValue::FLOATING) {
+                        value.floating = -value.floating;
+                        return value;
+                    }
+
+                    if (value.kind != EvalValue::INTEGER)
+                        unknown(id);
+
+                    return this->arithmetic(id, TokenType::MINUS, 0, value.integer, this->width(id));
+                }
+
+                case TokenType::PLUS_PLUS:
+                case TokenType::MINUS_MINUS: {
+                    return this->increment(id, node.first, value, node.token_type() == TokenType::PLUS_PLUS);
+                }
+
+                default: {
+                    unknown(id);
+                }
+
+            }
+        }
+
+        // x++ is what x was before
+        Value visit_suffix(NodeId id, const Node& node, const Value* operands, uint32_t) {
+            TokenType op = node.token_type();
+
+            if (op != TokenType::PLUS_PLUS && op != TokenType::MINUS_MINUS)
+                unknown(id);
+
+            this->increment(id, node.first, operands[0], op == TokenType::PLUS_PLUS);
+            return operands[0];
+        }
+
+        Value increment(NodeId id, NodeId target, const Value& value, bool up) {
+            if (value.kind != EvalValue::INTEGER)
+                unknown(id);
+
+            // assign() puts it in the variable's own type
+            Value next = this->arithmetic(id, up ? TokenType::PLUS : TokenType::MINUS, value.integer, 1, Literal::Width{});
+            return this->assign(id, target, next);
+        }
+
+        Value assign(NodeId id, NodeId target, const Value& value) {
+            if (this->ast.get(target).kind != NodeKind::VARIABLE)
+                unknown(target);
+
+            NodeId decl = this->sema.resolution(target);
+            auto found = this->bindings.find(decl);
+
+            if (found == this->bindings.end() || this->ast.get(decl).kind != NodeKind::MUTABLE)
+                unknown(target);
+
+            found->second.value = this->fit(value, this->ast.get(decl).first, id);
+            return found->second.value;
+        }
+
+        Value visit_reassign(NodeId id, const Node& node, const Value* operands, uint32_t) {
+            return this->assign(id, node.first, operands[1]);
+        }
+
+        Value visit_call(NodeId id, const Node&, const Value* operands, uint32_t count) {
+            return this->call(id, operands, count - 1);
+        }
+
+        Value visit_binary(NodeId id, const Node& node, const Value* operands, uint32_t) {
+            const Value& left = operands[0];
+            const Value& right = operands[1];
+            TokenType op = node.token_type();
+
+            bool equality = op == TokenType::EQUAL_EQUAL || op == TokenType::NOT_EQUAL;
+
+            // different kinds are never equal, anything else between them is the type checker's
+            if (left.kind != right.kind) {
+                if (!equality)
+                    unknown(id);
+                return boolean(op == TokenType::NOT_EQUAL);
+            }
+
+            if (op == TokenType::VARIADIC) {
+                if (left.kind != EvalValue::INTEGER)
+                    unknown(id);
+
+                Value range{EvalValue::RANGE};
+                range.integer = left.integer;
+                range.end = right.integer;
+                return range;
+            }
+
+            int order = 0;
+
+            switch (left.kind) {
+
+                case EvalValue::INTEGER: {
+                    if (Literal::arithmetic(op))
+                        return this->arithmetic(id, op, left.integer, right.integer, this->width(id));
+
+                    order = left.integer < right.integer ? -1 : left.integer > right.integer ? 1 : 0;
+                    break;
+                }
+
+                case EvalValue::FLOATING: {
+                    if (Literal::arithmetic(op)) {
+                        Value value{EvalValue::FLOATING};
+                        value.floating = Literal::step(op, left.floating, right.floating, this->width(id));
+                        return value;
+                    }
+
+                    order = Literal::order(left.floating, right.floating);
+                    break;
+                }
+
+                case EvalValue::STRING: {
+                    if (op == TokenType::PLUS) {
+                        auto made = std::make_shared<Made>(std::string(text(left)) + std::string(text(right)), this->strings);
+                        this->charge();
+
+                        Value value{EvalValue::STRING};
+                        value.text = std::shared_ptr<const std::string>(made, &made->text);
+                        return value;
+                    }
+
+                    int compared = text(left).compare(text(right));
+                    order = compared < 0 ? -1 : compared > 0 ? 1 : 0;
+                    break;
+                }
+
+                case EvalValue::NIL: {
+                    if (!equality)
+                        unknown(id);
+                    order = 0;
+                    break;
+                }
+
+                default: {
+                    if (!equality || left.kind == EvalValue::RANGE)
+                        unknown(id);
+                    order = left.id == right.id ? 0 : 2;
+                    break;
+                }
+
+            }
+
+            bool holds;
+
+            if (!Literal::compares(op, order, holds))
+                unknown(id);
+
+            return boolean(holds);
+        }
+};
+
+#endif
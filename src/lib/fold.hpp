@@ -0,0 +1,251 @@
+#ifndef FOLD_HPP
+#define FOLD_HPP
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "ast.hpp"
+#include "visitor.hpp"
+#include "literal.hpp"
+#include "operators.hpp"
+
+// evaluates arithmetic and comparisons on literals ahead of time, drops
+// groupings and takes out x + 0, x - 0, x * 1, x / 1 and -(-x). it runs on the
+// way out of every node so a whole constant tree folds bottom up, and every
+// rewrite is done in place with Ast::replace so nothing above has to know.
+//
+// the number type of a let or const is handed down through the arithmetic in
+// its value, and every step is done in that type the way it will be at run
+// time, see Literal::step. a negative result is written the way the parser
+// would, a prefix minus on a literal. it never turns a program down that would
+// have been accepted without it, so a signed step that overflows, a division by
+// zero or one whose operands aren't in the type yet are just left for later
+class ConstantFolder : public Visitor<ConstantFolder> {
+    Ast& ast;
+
+    // the annotation of the let or const a node is part of the value of, per
+    // node. Literal::NO_TYPE where there isn't one
+    std::vector<uint8_t> annotated;
+
+    struct Constant {
+        enum Kind : uint8_t { NONE, INTEGER, FLOATING, BOOLEAN };
+
+        Kind            kind     = NONE;
+        Literal::Number integer  = {}; // and 0 or 1 for a bool
+        double          floating = 0;
+    };
+
+    size_t folded = 0;
+
+    typedef Literal::Width Width;
+
+    Constant constant(NodeId id) const {
+        const Node& node = this->ast.get(id);
+        Constant value;
+
+        switch (node.kind) {
+
+            case NodeKind::INT_LIT: {
+                value.kind = Constant::INTEGER;
+                value.integer.magnitude = this->ast.integer(node);
+                break;
+            }
+
+            case NodeKind::FLOAT_LIT: {
+                value.kind = Constant::FLOATING;
+                value.floating = this->ast.floating(node);
+                break;
+            }
+
+            case NodeKind::BOOL_LIT: {
+                value.kind = Constant::BOOLEAN;
+                value.integer.magnitude = node.first;
+                break;
+            }
+
+            // the only way to write a negative number
+            case NodeKind::PREFIX: {
+                if (node.token_type() != TokenType::MINUS)
+                    break;
+
+                const Node& operand = this->ast.get(node.first);
+
+                if (operand.kind == NodeKind::INT_LIT) {
+                    value.kind = Constant::INTEGER;
+                    value.integer.magnitude = this->ast.integer(operand);
+                    value.integer.negative = value.integer.magnitude != 0;
+                } else if (operand.kind == NodeKind::FLOAT_LIT) {
+                    value.kind = Constant::FLOATING;
+                    value.floating = -this->ast.floating(operand);
+                }
+                break;
+            }
+
+            default: {
+                break;
+            }
+
+        }
+
+        return value;
+    }
+
+    NodeId literal(SourceLoc loc, const Constant& value) {
+        switch (value.kind) {
+            case Constant::INTEGER:  return this->ast.add_number(loc, value.integer);
+            case Constant::FLOATING: return this->ast.add_number(loc, value.floating);
+            default:                 return this->ast.add_bool(loc, value.integer.magnitude != 0);
+        }
+    }
+
+    static bool is_integer(const Constant& value, Literal::uint128 wanted) {
+        return value.kind == Constant::INTEGER && !value.integer.negative && value.integer.magnitude == wanted;
+    }
+
+    // x + 0 is only x when x is a number, which these never are
+    bool maybe_number(NodeId id) const {
+        NodeKind kind = this->ast.get(id).kind;
+        return kind != NodeKind::STRING_LIT && kind != NodeKind::BOOL_LIT && kind != NodeKind::NIL;
+    }
+
+    // both sides are constants of the same kind. false leaves the node as it is
+    static bool evaluate(TokenType op, const Constant& left, const Constant& right, Width width, Constant& result) {
+        if (!Literal::arithmetic(op)) {
+            bool holds;
+
+            if (left.kind == Constant::BOOLEAN) {
+                if (op != TokenType::EQUAL_EQUAL && op != TokenType::NOT_EQUAL)
+                    return false;
+                holds = (left.integer.magnitude == right.integer.magnitude) == (op == TokenType::EQUAL_EQUAL);
+            } else {
+                int order = left.kind == Constant::FLOATING ? Literal::order(left.floating, right.floating)
+                                                            : Literal::order(left.integer, right.integer);
+
+                if (!Literal::compares(op, order, holds))
+                    return false;
+            }
+
+            result = Constant{Constant::BOOLEAN};
+            result.integer.magnitude = holds;
+            return true;
+        }
+
+        if (left.kind == Constant::BOOLEAN)
+            return false;
+
+        if (left.kind == Constant::FLOATING) {
+            double value = Literal::step(op, left.floating, right.floating, width);
+
+            // infinities and nans are left to happen at run time
+            if (!std::isfinite(value))
+                return false;
+
+            result = Constant{Constant::FLOATING};
+            result.floating = value;
+            return true;
+        }
+
+        // whatever happens at run time, it isn't the folder's to report
+        result = Constant{Constant::INTEGER};
+        return Literal::step(op, left.integer, right.integer, width, result.integer) == Literal::Step::DONE;
+    }
+
+    void fold(NodeId id, const Constant& value) {
+        this->ast.replace(id, this->literal(this->ast.loc(id), value));
+        this->folded++;
+    }
+
+    void simplify(NodeId id, NodeId with) {
+        this->ast.replace(id, with);
+        this->folded++;
+    }
+
+    public:
+        explicit ConstantFolder(Ast& ast) : ast(ast) {}
+
+        void fold_all(const std::vector<NodeId>& statements) {
+            this->annotated.assign(this->ast.size(), Literal::NO_TYPE);
+
+            for (NodeId statement : statements)
+                this->ast.walk(statement,
+                    [&](NodeId id) { this->enter(id); return true; },
+                    [&](NodeId id, uint32_t) { this->visit(this->ast, id); });
+        }
+
+        size_t folded_count(void) const { return this->folded; }
+
+        // hands the annotation down to the value and from there to everything
+        // worked out in it
+        void enter(NodeId id) {
+            const Node& node = this->ast.get(id);
+
+            if ((node.kind == NodeKind::MUTABLE || node.kind == NodeKind::CONSTANT) && node.second != NO_NODE)
+                this->annotated[node.second] = this->ast.number_type(node.first);
+
+            this->ast.each_in_type(id, [&](NodeId child) { this->annotated[child] = this->annotated[id]; });
+        }
+
+        void visit_binary(NodeId id, const Node& node) {
+            Node binary = node;
+            Constant left = this->constant(binary.first);
+            Constant right = this->constant(binary.second);
+            TokenType op = binary.token_type();
+
+            if (left.kind != Constant::NONE && left.kind == right.kind) {
+                Constant result;
+                if (evaluate(op, left, right, Literal::width_of_annotation(this->annotated[id]), result))
+                    this->fold(id, result);
+                return;
+            }
+
+            bool left_number = this->maybe_number(binary.first);
+            bool right_number = this->maybe_number(binary.second);
+
+            if ((op == TokenType::PLUS || op == TokenType::MINUS) && is_integer(right, 0) && left_number)
+                this->simplify(id, binary.first);
+            else if ((op == TokenType::MULT || op == TokenType::DIV) && is_integer(right, 1) && left_number)
+                this->simplify(id, binary.first);
+            else if (op == TokenType::PLUS && is_integer(left, 0) && right_number)
+                this->simplify(id, binary.second);
+            else if (op == TokenType::MULT && is_integer(left, 1) && right_number)
+                this->simplify(id, binary.second);
+        }
+
+        void visit_prefix(NodeId id, const Node& node) {
+            if (node.token_type() != TokenType::MINUS)
+                return;
+
+            Node operand = this->ast.get(node.first);
+
+            if (operand.kind != NodeKind::PREFIX || operand.token_type() != TokenType::MINUS)
+                return;
+
+            // -(-5) is a number that still has to go in the type, -(-x) is just x
+            Constant value = this->constant(node.first);
+            Width width = Literal::width_of_annotation(this->annotated[id]);
+
+            if (value.kind == Constant::INTEGER && width.bits != 0 && !width.floating) {
+                value.integer.negative = false;
+
+                // -(-128) as an i8 is left for run time
+                if (!Literal::narrow(value.integer.magnitude, value.integer.negative, width.bits, width.is_signed))
+                    return;
+
+                if (value.integer.magnitude != this->ast.integer(this->ast.get(operand.first))) {
+                    this->fold(id, value);
+                    return;
+                }
+            }
+
+            this->simplify(id, operand.first);
+        }
+
+        // the tree already says what the parentheses did
+        void visit_grouping(NodeId id, const Node& node) {
+            this->simplify(id, node.first);
+        }
+};
+
+#endif
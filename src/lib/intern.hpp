@@ -0,0 +1,133 @@
+#ifndef INTERN_HPP
+#define INTERN_HPP
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+typedef uint32_t SymbolId;
+
+// process wide table of every identifier and string literal. each distinct text
+// is stored once and everything past the lexer refers to it by SymbolId, so name
+// comparisons and hashing are on integers.
+//
+// only interning takes the lock. the texts go in pages that never move, page k
+// holding PAGE_SIZE << k of them, and the count is published once each entry is
+// written, so text() and size() are plain reads from any thread
+class Interner {
+    static constexpr SymbolId EMPTY     = UINT32_MAX;
+    static constexpr size_t   PAGE_BITS = 10;
+    static constexpr size_t   PAGE_SIZE = static_cast<size_t>(1) << PAGE_BITS;
+    static constexpr size_t   MAX_PAGES = 32 - PAGE_BITS + 1;
+
+    inline static std::mutex mutex;
+
+    inline static std::unique_ptr<std::string_view[]> owned_pages[MAX_PAGES] = {};
+    inline static std::atomic<std::string_view*>      pages[MAX_PAGES]       = {};
+    inline static std::atomic<size_t>                 count                  = 0;
+
+    inline static std::vector<uint32_t> hashes = {};
+    inline static std::vector<SymbolId> slots  = std::vector<SymbolId>(1024, EMPTY);
+
+    // text that doesn't live in a source file gets copied in here
+    inline static std::deque<std::string> owned = {};
+
+    static uint32_t hash(std::string_view text) {
+        uint32_t hash = 2166136261u;
+        for (char character : text)
+            hash = (hash ^ static_cast<uint8_t>(character)) * 16777619u;
+        return hash;
+    }
+
+    // page k starts at id PAGE_SIZE * (2^k - 1)
+    static size_t page_of(SymbolId id) {
+        return 63 - __builtin_clzll((static_cast<size_t>(id) >> PAGE_BITS) + 1);
+    }
+
+    static std::string_view& entry(SymbolId id) {
+        size_t page = page_of(id);
+        size_t first = ((static_cast<size_t>(1) << page) - 1) << PAGE_BITS;
+        return pages[page].load(std::memory_order_acquire)[id - first];
+    }
+
+    static void grow(void) {
+        std::vector<SymbolId> bigger(slots.size() * 2, EMPTY);
+        size_t mask = bigger.size() - 1;
+
+        for (SymbolId id = 0; id < hashes.size(); id++) {
+            size_t slot = hashes[id] & mask;
+            while (bigger[slot] != EMPTY)
+                slot = (slot + 1) & mask;
+            bigger[slot] = id;
+        }
+
+        slots = std::move(bigger);
+    }
+
+    static SymbolId insert(std::string_view text, bool copy) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        uint32_t text_hash = hash(text);
+        size_t mask = slots.size() - 1;
+        size_t slot = text_hash & mask;
+
+        while (slots[slot] != EMPTY) {
+            SymbolId id = slots[slot];
+            if (hashes[id] == text_hash && entry(id) == text)
+                return id;
+            slot = (slot + 1) & mask;
+        }
+
+        if (copy) {
+            owned.push_back(std::string(text));
+            text = owned.back();
+        }
+
+        SymbolId id = hashes.size();
+        size_t page = page_of(id);
+
+        if (!owned_pages[page]) {
+            owned_pages[page].reset(new std::string_view[PAGE_SIZE << page]);
+            pages[page].store(owned_pages[page].get(), std::memory_order_release);
+        }
+
+        entry(id) = text;
+        hashes.push_back(text_hash);
+        slots[slot] = id;
+        count.store(hashes.size(), std::memory_order_release);
+
+        // keep the table at most half full
+        if (hashes.size() * 2 > slots.size())
+            grow();
+
+        return id;
+    }
+
+    public:
+        // for slices of a loaded source file, which outlive the interner anyway
+        static SymbolId intern(std::string_view text) {
+            return insert(text, false);
+        }
+
+        // for anything else, the text is copied the first time it's seen
+        static SymbolId intern_copy(std::string_view text) {
+            return insert(text, true);
+        }
+
+        static std::string_view text(SymbolId id) {
+            return entry(id);
+        }
+
+        static size_t size(void) {
+            return count.load(std::memory_order_acquire);
+        }
+};
+
+#endif
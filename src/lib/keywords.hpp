@@ -0,0 +1,109 @@
+#ifndef KEYWORDS_HPP
+#define KEYWORDS_HPP
+
+#pragma once
+
+#include <string_view>
+#include <array>
+#include <cstdint>
+
+#include "token.hpp"
+
+namespace Keywords {
+
+struct Keyword {
+    std::string_view text;
+    TokenType        token_type;
+};
+
+// every keyword in the language, the lookup table below is generated from this at compile time
+constexpr Keyword list[] = {
+    {"if",        TokenType::IF         },
+    {"else",      TokenType::ELSE       },
+    {"for",       TokenType::FOR        },
+    {"while",     TokenType::WHILE      },
+    {"func",      TokenType::FUNC       },
+    {"struct",    TokenType::STRUCT     },
+    {"enum",      TokenType::ENUM       },
+    {"class",     TokenType::CLASS      },
+    {"final",     TokenType::FINAL      },
+    {"interface", TokenType::INTERFACE  },
+    {"return",    TokenType::RETURN     },
+    {"throw",     TokenType::THROW      },
+    {"import",    TokenType::IMPORT     },
+    {"string",    TokenType::STR        },
+    {"int",       TokenType::INT_TYPE   },
+    {"i8",        TokenType::INT8       },
+    {"i16",       TokenType::INT16      },
+    {"i32",       TokenType::INT32      },
+    {"i64",       TokenType::INT64      },
+    {"i128",      TokenType::INT128     },
+    {"u8",        TokenType::UINT8      },
+    {"u16",       TokenType::UINT16     },
+    {"u32",       TokenType::UINT32     },
+    {"u64",       TokenType::UINT64     },
+    {"u128",      TokenType::UINT128    },
+    {"bool",      TokenType::BOOL_TYPE  },
+    {"float",     TokenType::FLOAT_TYPE },
+    {"double",    TokenType::DOUBLE_TYPE},
+    {"nil",       TokenType::NIL        },
+    {"true",      TokenType::TRUE       },
+    {"false",     TokenType::FALSE      },
+    {"type",      TokenType::TYPE       },
+    {"let",       TokenType::LET        },
+    {"const",     TokenType::CONST      },
+    {"static",    TokenType::STATIC     },
+};
+
+constexpr size_t TABLE_SIZE = 128;
+constexpr size_t MIN_LENGTH = 2;
+constexpr size_t MAX_LENGTH = 9;
+
+// the multipliers were picked so every keyword gets a slot to itself. if a new
+// keyword trips the static_assert below, search for a new set of them
+constexpr uint32_t hash(std::string_view word) {
+    return (word.length() * 2
+          + static_cast<uint8_t>(word[0]) * 57
+          + static_cast<uint8_t>(word[1]) * 3
+          + static_cast<uint8_t>(word[word.length() - 1])) & (TABLE_SIZE - 1);
+}
+
+struct Table {
+    std::array<Keyword, TABLE_SIZE> slots;
+    bool                            perfect;
+};
+
+constexpr Table build_table(void) {
+    Table table = {};
+
+    for (Keyword& slot : table.slots)
+        slot = Keyword{"", TokenType::IDENT};
+
+    table.perfect = true;
+
+    for (const Keyword& keyword : list) {
+        Keyword& slot = table.slots[hash(keyword.text)];
+        if (!slot.text.empty())
+            table.perfect = false;
+        slot = keyword;
+    }
+
+    return table;
+}
+
+constexpr Table table = build_table();
+
+static_assert(table.perfect, "keyword hash has a collision, retune Keywords::hash");
+
+// one hash and at most one compare, anything that isn't a keyword is an IDENT
+inline TokenType lookup(std::string_view word) {
+    if (word.length() < MIN_LENGTH || word.length() > MAX_LENGTH)
+        return TokenType::IDENT;
+
+    const Keyword& slot = table.slots[hash(word)];
+    return slot.text == word ? slot.token_type : TokenType::IDENT;
+}
+
+}
+
+#endif
@@ -5,59 +5,103 @@
 
 #include <vector>
 #include <string>
-#include <iostream>
-#include <cctype>
+#include <string_view>
 #include <memory>
+#include <array>
+#include <cstring>
+#include <cassert>
 
 #include "token.hpp"
+#include "source.hpp"
+#include "keywords.hpp"
+#include "chars.hpp"
+#include "operators.hpp"
+#include "scan.hpp"
+#include "pool.hpp"
+#include "errors.hpp"
 
 class Lexer {
-    std::string source;
-    std::string filename;
-    std::vector<std::string> lines;
+    std::string_view source;
+    uint32_t file_id;
 
-    int index;
-    int start;
+    size_t index;
+    size_t start;
+    size_t end;
 
-    int line;
+    // where every line in [begin, end) starts. a lexer over the whole file hands
+    // them to the SourceManager once it reaches the end, chunks are stitched
+    // together by ParallelLexer
+    std::vector<size_t> line_starts;
+    bool                whole_file;
 
-    int initial_position;
-    int final_position;
+    TokenEntry pending;
+    bool       has_pending;
 
-    std::vector<std::shared_ptr<Token>> output;
+    // a bad character is reported and skipped, lexing carries on past it
+    Diagnostics& diagnostics;
 
     public:
-        inline Lexer(const std::string source, const std::string filename, const std::vector<std::string> lines) {
-            this->source = source;
-            this->filename = filename;
-            this->lines = lines;
+        inline Lexer(uint32_t file_id, Diagnostics& diagnostics)
+          : Lexer(file_id, diagnostics, 0, SourceManager::get(file_id).get_contents().length()) {}
 
-            this->index = 0;
-            this->start = 0;
+        // lexes only [begin, end) of the file, which has to start and end between tokens
+        inline Lexer(uint32_t file_id, Diagnostics& diagnostics, size_t begin, size_t end)
+          : diagnostics(diagnostics) {
+            this->source = SourceManager::get(file_id).get_contents();
+            this->file_id = file_id;
 
-            this->line = 1;
+            this->index = begin;
+            this->start = begin;
+            this->end = end;
 
-            this->initial_position = 1;
-            this->final_position = 1;
+            this->whole_file = begin == 0 && end == this->source.length();
+            if (begin == 0)
+                this->line_starts.push_back(0);
 
-            this->output = {};
+            this->has_pending = false;
         }
 
         inline ~Lexer() = default;
 
-        inline std::vector<std::shared_ptr<Token>> lex(void) {
+        inline TokenBuffer lex(void) {
+            TokenBuffer output(this->file_id);
+            TokenEntry token;
+
+            do {
+                token = this->next_token();
+                output.push(token);
+            } while (token.token_type != TokenType::END_OF_FILE);
+
+            return output;
+        }
+
+        // lexes only as far as the next token, keeps handing out END_OF_FILE once the source runs out
+        inline TokenEntry next_token(void) {
             while (!this->at_end()) {
                 this->start = this->index;
-                this->initial_position = this->final_position;
                 this->lex_token();
+
+                if (this->has_pending) {
+                    this->has_pending = false;
+                    return this->pending;
+                }
+            }
+
+            if (this->whole_file) {
+                SourceManager::set_line_starts(this->file_id, std::move(this->line_starts));
+                this->whole_file = false;
             }
-            this->create_token(TokenType::END_OF_FILE, "", TokenType::INTRINSIC);
-            return this->output;
+
+            return TokenEntry{TokenType::END_OF_FILE, this->index, 0};
         }
 
+        inline std::vector<size_t> take_line_starts(void) { return std::move(this->line_starts); }
+
+        inline uint32_t get_file_id(void) const { return this->file_id; }
+
     private:
         inline bool at_end(void) {
-            return this->index >= this->source.length();
+            return this->index >= this->end;
         }
 
         inline bool match(char target) {
@@ -66,41 +110,66 @@ class Lexer {
             return false;
         }
 
-        inline char peek(void) { return this->source[this->index]; }
+        inline char peek(void) { return this->at_end() ? '\0' : this->source[this->index]; }
 
         inline char advance(void) {
             char character = this->source[this->index];
             this->index++;
-            this->final_position++;
             return character;
         }
 
-        inline void create_token(TokenType token_type, std::string lexeme, TokenType data_type) {
-            Token token;
-            token.token_type = token_type;
-            token.lexeme = lexeme;
-            token.data_type = data_type;
-            token.position = Position{this->line, std::vector<int>{this->initial_position, this->final_position}};
-            token.filename = this->filename;
-            this->output.push_back(std::make_shared<Token>(token));
+        // records the start of the line after every newline in [from, to), only
+        // called for runs that are already known to have some
+        inline void mark_lines(size_t from, size_t to) {
+            const char* begin = this->source.data();
+            const char* position = begin + from;
+            const char* limit = begin + to;
+
+            while ((position = static_cast<const char*>(std::memchr(position, '\n', limit - position))) != nullptr) {
+                position++;
+                this->line_starts.push_back(position - begin);
+            }
+        }
+
+        // about the text from start to index
+        inline void report(std::string message) {
+            std::string_view lexeme = this->source.substr(this->start, this->index - this->start);
+            this->diagnostics.report(std::move(message), Token{TokenType::END_OF_FILE, lexeme, this->start, this->file_id});
+        }
+
+        inline const char* cursor(void) { return this->source.data() + this->index; }
+
+        inline const char* limit(void) { return this->source.data() + this->end; }
+
+        // moves the lexer to a position one of the Scan functions stopped at
+        inline void jump(const char* position) { this->index = position - this->source.data(); }
+
+        // operators and keywords are exactly the text between start and index
+        inline void create_token(TokenType token_type) {
+            this->pending = TokenEntry{token_type, this->start, static_cast<uint32_t>(this->index - this->start)};
+            this->has_pending = true;
+        }
+
+        // literals whose lexeme is only part of the scanned text, eg. strings without their quotes
+        inline void create_token(TokenType token_type, std::string_view lexeme) {
+            this->pending = TokenEntry{token_type, static_cast<size_t>(lexeme.data() - this->source.data()), static_cast<uint32_t>(lexeme.length())};
+            this->has_pending = true;
         }
 
         inline void string(void) {
-            std::string buffer = "";
+            size_t begin = this->index;
+            size_t lines = 0;
 
-            while (!this->at_end() && this->peek() != '"') {
-                if (this->peek() == '\n') {
-                    this->line++;
-                    this->final_position = 1;
-                }
+            this->jump(Scan::find(this->cursor(), this->limit(), '"', lines));
+            if (lines > 0)
+                this->mark_lines(begin, this->index);
 
-                if (this->peek() == '\"') {}
+            std::string_view buffer = this->source.substr(begin, this->index - begin);
 
-                buffer += this->peek();
-                this->advance();
-            }
-            this->advance();
-            this->create_token(TokenType::STRING, buffer, TokenType::STRING);
+            if (!this->match('"'))
+                this->report("Unterminated string");
+
+            this->create_token(TokenType::STRING, buffer);
         }
 
         inline void number(void) {
@@ -108,30 +177,25 @@ class Lexer {
             bool is_binary = false;
             bool is_hex = false;
 
-            std::string buffer = "";
-            buffer += this->source[this->index - 1];
+            size_t begin = this->index - 1;
 
-            while (std::isdigit(this->peek())) {
-                buffer += this->advance();
-            }
+            this->jump(Scan::digits(this->cursor(), this->limit()));
 
             switch (this->peek()) {
 
                 case 'b': {
                     is_binary = true;
-                    buffer = "";
                     this->advance(); // move past 'b' character
                     while (this->peek() == '0' || this->peek() == '1')
-                        buffer += this->advance();
+                        this->advance();
                     break;
                 }
 
                 case 'x': {
                     is_hex = true;
-                    buffer = "";
                     this->advance(); // move past 'x' character
-                    while (std::isxdigit(this->peek()))
-                        buffer += this->advance();
+                    while (Chars::is(this->peek(), Chars::HEX))
+                        this->advance();
                     break;
                 }
 
@@ -142,276 +206,283 @@ class Lexer {
                         break;
                     }
                     is_float = true;
-                    buffer += '.';
-                    while (std::isdigit(this->peek()))
-                        buffer += this->advance();
+                    this->jump(Scan::digits(this->cursor(), this->limit()));
                     break;
                 }
 
             }
 
-            if (is_float) this->create_token(TokenType::FLOAT, buffer, TokenType::FLOAT);
-            else if (is_hex) this->create_token(TokenType::INT, buffer, TokenType::INT);
-            else if (is_binary) this->create_token(TokenType::INT, buffer, TokenType::INT);
-            else this->create_token(TokenType::INT, buffer, TokenType::INT);
+            std::string_view buffer = this->source.substr(begin, this->index - begin);
+
+            if (is_float) this->create_token(TokenType::FLOAT, buffer);
+            else if (is_hex) this->create_token(TokenType::INT, buffer);
+            else if (is_binary) this->create_token(TokenType::INT, buffer);
+            else this->create_token(TokenType::INT, buffer);
             
         }
 
         inline void identifier(void) {
-            std::string buffer = "";
-            buffer += this->source[this->index - 1];
-
-            while (std::isalnum(this->peek()) || this->peek() == '_')
-                buffer += this->advance();
-
-            // the great if else wall (please keep it aligned, the wall must not fall)
-            if      (buffer == "if")        this->create_token(TokenType::IF,        buffer, TokenType::INTRINSIC);
-            else if (buffer == "else")      this->create_token(TokenType::ELSE,      buffer, TokenType::INTRINSIC);               
-            else if (buffer == "for")       this->create_token(TokenType::FOR,       buffer, TokenType::INTRINSIC); 
-            else if (buffer == "while")     this->create_token(TokenType::WHILE,     buffer, TokenType::INTRINSIC); 
-            else if (buffer == "func")      this->create_token(TokenType::FUNC,      buffer, TokenType::INTRINSIC);
-            else if (buffer == "struct")    this->create_token(TokenType::STRUCT,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "enum")      this->create_token(TokenType::ENUM,      buffer, TokenType::INTRINSIC);
-            else if (buffer == "class")     this->create_token(TokenType::CLASS,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "final")     this->create_token(TokenType::FINAL,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "interface") this->create_token(TokenType::INTERFACE, buffer, TokenType::INTRINSIC);
-            else if (buffer == "return")    this->create_token(TokenType::RETURN,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "throw")     this->create_token(TokenType::THROW,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "import")    this->create_token(TokenType::IMPORT,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "string")    this->create_token(TokenType::STR,       buffer, TokenType::INTRINSIC);
-            else if (buffer == "int")       this->create_token(TokenType::INT_TYPE,  buffer, TokenType::INTRINSIC);
-            else if (buffer == "i8")        this->create_token(TokenType::INT8,      buffer, TokenType::INTRINSIC);
-            else if (buffer == "i16")       this->create_token(TokenType::INT16,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "i32")       this->create_token(TokenType::INT32,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "i64")       this->create_token(TokenType::INT64,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "i128")      this->create_token(TokenType::INT128,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "u8")        this->create_token(TokenType::UINT8,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "u16")       this->create_token(TokenType::UINT16,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "u32")       this->create_token(TokenType::UINT32,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "u64")       this->create_token(TokenType::UINT64,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "u128")      this->create_token(TokenType::UINT128,   buffer, TokenType::INTRINSIC);
-            else if (buffer == "bool")      this->create_token(TokenType::BOOL_TYPE, buffer, TokenType::INTRINSIC);
-            else if (buffer == "float")     this->create_token(TokenType::FLOAT,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "double")    this->create_token(TokenType::DOUBLE,    buffer, TokenType::INTRINSIC);
-            else if (buffer == "nil")       this->create_token(TokenType::NIL,       buffer, TokenType::INTRINSIC);
-            else if (buffer == "true")      this->create_token(TokenType::TRUE,      buffer, TokenType::BOOL     );
-            else if (buffer == "false")     this->create_token(TokenType::FALSE,     buffer, TokenType::BOOL     );
-            else if (buffer == "type")      this->create_token(TokenType::TYPE,      buffer, TokenType::INTRINSIC);
-            else if (buffer == "let")       this->create_token(TokenType::LET,       buffer, TokenType::INTRINSIC);
-            else if (buffer == "const")     this->create_token(TokenType::CONST,     buffer, TokenType::INTRINSIC);
-            else if (buffer == "static")    this->create_token(TokenType::STATIC,    buffer, TokenType::INTRINSIC);
-            else                            this->create_token(TokenType::IDENT,     buffer, TokenType::IDENT    );
-        }
+            this->jump(Scan::identifier(this->cursor(), this->limit()));
 
-        inline void lex_token(void) {
-            char character = this->advance();
+            std::string_view buffer = this->source.substr(this->start, this->index - this->start);
 
-            switch (character) {
+            this->create_token(Keywords::lookup(buffer));
+        }
 
-                case '.': {
-                    if (this->match('.')) this->create_token(TokenType::VARIADIC, "..", TokenType::OPERAND);
-                    else this->create_token(TokenType::DOT, ".", TokenType::OPERAND);
+        // longest operator starting at start, backing off to the last state that
+        // accepted if a longer match dies part way (none of today's operators need it)
+        inline void symbol(char character) {
+            uint8_t state = Operators::step(0, character);
+            uint8_t accepted = Operators::machine.accept[state];
+            size_t accepted_end = this->index;
+
+            while (!this->at_end()) {
+                state = Operators::step(state, this->source[this->index]);
+                if (state == 0)
                     break;
-                }
 
-                case '+': {
-                    if (this->match('+')) {
-                        this->create_token(TokenType::PLUS_PLUS, "++", TokenType::OPERAND);
-                    } else {
-                        this->create_token(TokenType::PLUS, "+", TokenType::OPERAND);
-                    } break;
+                this->index++;
+                if (Operators::machine.accept[state] != Operators::NO_TOKEN) {
+                    accepted = Operators::machine.accept[state];
+                    accepted_end = this->index;
                 }
+            }
 
-                case '-': {
-                    if (this->match('-')) {
-                        this->create_token(TokenType::MINUS_MINUS, "--", TokenType::OPERAND);
-                        break;
-                    } else {
-                        this->create_token(TokenType::MINUS, "-", TokenType::OPERAND);
-                        break;
-                    }
-                }
+            this->index = accepted_end;
+            this->create_token(static_cast<TokenType>(accepted));
+        }
 
-                case '@': {
-                    this->create_token(TokenType::AT, "@", TokenType::OPERAND);
-                    break;
-                }
+        inline void lex_token(void) {
+            char character = this->advance();
+
+            switch (character) {
 
                 case '/': {
                     if (this->match('/')) {
-                        while (this->peek() != '\n')
-                            this->advance();
-                        break;
+                        size_t lines = 0;
+                        this->jump(Scan::find(this->cursor(), this->limit(), '\n', lines));
                     } else if (this->match('*')) {
-                        bool is_looping = true;
-                        while (is_looping) {
-                            if (this->match('*')) {
-                                if (this->match('/')) {
-                                    is_looping = false;
-                                    break;
-                                }
-                            } else if (this->match('\n')) {
-                                this->line++;
-                                this->final_position = 1;
-                            } else {
-                                this->advance();
-                            }
-                        } break;
+                        size_t lines = 0;
+                        this->jump(Scan::block_comment_end(this->cursor(), this->limit(), lines));
+                        if (lines > 0)
+                            this->mark_lines(this->start, this->index);
                     } else {
-                        this->create_token(TokenType::DIV, "/", TokenType::OPERAND);
-                        break;
+                        this->symbol(character);
                     }
+                    break;
                 }
 
-                case '*': {
-                    if (this->match('*')) {
-                        this->create_token(TokenType::MULT_MULT, "**", TokenType::OPERAND);
-                        break;
-                    } else {
-                        this->create_token(TokenType::MULT, "*", TokenType::OPERAND);
-                        break;
-                    }
+                case '"': {
+                    this->string();
+                    break;
                 }
 
-                case '<': {
-                    if (this->match('<')) {
-                        this->create_token(TokenType::SHL, "<<", TokenType::OPERAND);
-                    } else if (this->match('=')) {
-                        this->create_token(TokenType::LT_EQUALS, "<=", TokenType::OPERAND);
-                    } else {
-                        this->create_token(TokenType::LT, "<", TokenType::OPERAND);                    
-                    } break;
+                // a whole run of whitespace goes at once, counting the newlines in it
+                case '\r': 
+                case '\t':
+                case ' ':
+                case '\n': {
+                    size_t lines = character == '\n';
+                    if (Scan::is_whitespace(this->peek()))
+                        this->jump(Scan::whitespace(this->cursor(), this->limit(), lines));
+                    if (lines > 0)
+                        this->mark_lines(this->start, this->index);
+                    break;
                 }
 
-                case '>': {
-                    if (this->match('>')) {
-                        this->create_token(TokenType::SHR, ">>", TokenType::OPERAND);
-                    } else if (this->match('=')) {
-                        this->create_token(TokenType::GT_EQUALS, ">=", TokenType::OPERAND);
-                    } else {
-                        this->create_token(TokenType::GT, ">", TokenType::OPERAND);                    
-                    } break;
-                }
+                default: {
+                    uint8_t classes = Chars::table[static_cast<uint8_t>(character)];
 
-                case '=': {
-                    if (this->match('=')) {
-                        this->create_token(TokenType::EQUAL_EQUAL, "==", TokenType::OPERAND);
-                        break;
+                    if (classes & Chars::IDENT_START) {
+                        this->identifier();
+                    } else if (classes & Chars::DIGIT) {
+                        this->number();
+                    } else if (classes & Chars::OPERATOR) {
+                        this->symbol(character);
                     } else {
-                        this->create_token(TokenType::EQUAL, "=", TokenType::OPERAND);
-                        break;
+                        this->report("Found unexpected character \"" + std::string(1, character) + "\"");
                     }
-                }
-
-                case '&': {
-                    this->create_token(TokenType::AMPERSAND, "&", TokenType::OPERAND);
                     break;
                 }
+            }
+        }
+};
 
-                case ';': {
-                    this->create_token(TokenType::SEMICOLON, ";", TokenType::OPERAND);
-                    break;
-                }
+// what the parser reads tokens through. either a TokenBuffer lexed up front,
+// or a lexer it pulls from on demand. when streaming only the last few tokens
+// are kept, which covers the parser stepping back a token with index--
+class TokenStream {
+    static constexpr size_t RING_SIZE = 16;
 
-                case ':': {
-                    if (this->match(':')) {
-                        this->create_token(TokenType::SCOPE, "::", TokenType::OPERAND);
-                        break;
-                    } else {
-                        this->create_token(TokenType::COLON, ":", TokenType::OPERAND);
-                        break;
-                    }
-                }
+    TokenBuffer      buffer;
+    Lexer*           lexer = nullptr;
 
-                case '#': {
-                    this->create_token(TokenType::HASH, "#", TokenType::OPERAND);
-                    break;
-                }
+    uint32_t         file_id;
+    std::string_view source;
 
-                case ',': {
-                    this->create_token(TokenType::COMMA, ",", TokenType::OPERAND);
-                    break;
-                }
+    std::array<TokenEntry, RING_SIZE> ring = {};
+    size_t                            filled = 0;
 
-                case '|': {
-                    this->create_token(TokenType::PIPE, "|", TokenType::OPERAND);
-                    break;
-                }
+    inline const TokenEntry& entry(size_t index) {
+        while (this->filled <= index) {
+            this->ring[this->filled & (RING_SIZE - 1)] = this->lexer->next_token();
+            this->filled++;
+        }
 
-                case '!': {
-                    if (this->match('=')) 
-                        this->create_token(TokenType::NOT_EQUAL, "!=", TokenType::OPERAND);
-                    else
-                        this->create_token(TokenType::BANG, "!", TokenType::OPERAND);
-                    break;
-                }
+        // the parser never steps back more than a token or two
+        assert(index + RING_SIZE >= this->filled && "parser stepped back further than the token stream keeps");
 
-                case '?': {
-                    this->create_token(TokenType::QUESTION, "?", TokenType::OPERAND);
-                    break;
-                }
+        return this->ring[index & (RING_SIZE - 1)];
+    }
 
-                case '(': {
-                    this->create_token(TokenType::L_PAREN, "(", TokenType::OPERAND);
-                    break;
-                }
+    public:
+        inline TokenStream(TokenBuffer buffer)
+          : buffer(std::move(buffer)) {
+            this->file_id = this->buffer.get_file_id();
+            this->source = SourceManager::get(this->file_id).get_contents();
+        }
 
-                case ')': {
-                    this->create_token(TokenType::R_PAREN, ")", TokenType::OPERAND);
-                    break;
-                }
+        inline TokenStream(Lexer* lexer)
+          : buffer(lexer->get_file_id()), lexer(lexer) {
+            this->file_id = lexer->get_file_id();
+            this->source = SourceManager::get(this->file_id).get_contents();
+        }
 
-                case '{': {
-                    this->create_token(TokenType::L_BRACE, "{", TokenType::OPERAND);
-                    break;
-                }
+        inline TokenType kind(size_t index) {
+            if (this->lexer == nullptr)
+                return this->buffer.kind(index);
+            return this->entry(index).token_type;
+        }
 
-                case '}': {
-                    this->create_token(TokenType::R_BRACE, "}", TokenType::OPERAND);
-                    break;
-                }
+        inline SourceLoc loc(size_t index) {
+            if (this->lexer == nullptr)
+                return this->buffer.loc(index);
+            return SourceLoc::at(this->entry(index).offset);
+        }
 
-                case '[': {
-                    this->create_token(TokenType::L_SQUARE, "[", TokenType::OPERAND);
-                    break;
-                }
+        inline uint32_t get_file_id(void) const { return this->file_id; }
 
-                case ']': {
-                    this->create_token(TokenType::R_SQUARE, "]", TokenType::OPERAND);
-                    break;
-                }
+        // only a buffered stream can be rewound to an arbitrary token
+        inline bool buffered(void) const { return this->lexer == nullptr; }
 
-                case '"': {
-                    this->string();
-                    break;
-                }
+        inline Token get(size_t index) {
+            if (this->lexer == nullptr)
+                return this->buffer.get(index);
 
-                case '\r': 
-                case '\t':
-                case ' ':
-                    break;
-                
+            const TokenEntry& entry = this->entry(index);
+            return Token{entry.token_type, this->source.substr(entry.offset, entry.length), entry.offset, this->file_id};
+        }
+};
 
-                case '\n': {
-                    this->line++;
-                    this->final_position = 1;
-                    break;
+// lexes big files in chunks on a thread pool. chunk starts come from a quick
+// serial pass that only follows strings and comments, so each chunk begins on a
+// line the lexer reaches between tokens and can be lexed on its own
+class ParallelLexer {
+    struct Boundary {
+        size_t offset;
+    };
+
+    public:
+        static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+        static TokenBuffer lex(uint32_t file_id, size_t jobs, Diagnostics& diagnostics) {
+            std::string_view source = SourceManager::get(file_id).get_contents();
+            size_t chunks = std::min(jobs * 4, source.length() / MIN_CHUNK_SIZE);
+
+            if (jobs <= 1 || chunks <= 1)
+                return Lexer(file_id, diagnostics).lex();
+
+            std::vector<Boundary> boundaries = ParallelLexer::boundaries(source, chunks);
+            std::vector<TokenBuffer> results(boundaries.size() - 1, TokenBuffer(file_id));
+            std::vector<Diagnostics> problems(results.size(), Diagnostics(diagnostics.get_limit()));
+            std::vector<std::vector<size_t>> starts(results.size());
+
+            {
+                ThreadPool pool(std::min(jobs, results.size()));
+
+                for (size_t i = 0; i < results.size(); i++) {
+                    pool.submit([&, i]() {
+                        Lexer lexer(file_id, problems[i], boundaries[i].offset, boundaries[i + 1].offset);
+                        TokenEntry token = lexer.next_token();
+
+                        while (token.token_type != TokenType::END_OF_FILE) {
+                            results[i].push(token);
+                            token = lexer.next_token();
+                        }
+
+                        starts[i] = lexer.take_line_starts();
+                    });
                 }
 
-                default: {
-                    if (std::isalpha(character) || character == '_') {
-                        this->identifier();
-                        break;
-                    } else if (std::isdigit(character)) {
-                        this->number();
+                pool.wait();
+            }
+
+            size_t total = 1;
+            for (TokenBuffer& result : results)
+                total += result.size();
+
+            TokenBuffer output(file_id);
+            output.reserve(total);
+
+            for (TokenBuffer& result : results)
+                output.append(result);
+
+            for (Diagnostics& chunk : problems)
+                diagnostics.append(chunk);
+
+            // every chunk starts right after a newline, so its line starts carry on
+            // from the one before
+            std::vector<size_t> line_starts = std::move(starts[0]);
+            for (size_t i = 1; i < starts.size(); i++)
+                line_starts.insert(line_starts.end(), starts[i].begin(), starts[i].end());
+
+            SourceManager::set_line_starts(file_id, std::move(line_starts));
+
+            output.push(TokenType::END_OF_FILE, source.length(), 0);
+            return output;
+        }
+
+    private:
+        // walks the file like the lexer would but only stops for quotes, slashes and
+        // newlines, and cuts after the first newline outside a string or comment
+        // past each even split point. the last boundary is the end of the file
+        static std::vector<Boundary> boundaries(std::string_view source, size_t chunks) {
+            const char* begin = source.data();
+            const char* end = begin + source.length();
+            const char* position = begin;
+            size_t lines = 0; // the scanners count lines, nothing here needs them
+
+            std::vector<Boundary> output = {Boundary{0}};
+
+            for (size_t i = 1; i < chunks && position < end; i++) {
+                const char* target = begin + source.length() / chunks * i;
+                bool found = false;
+
+                while (!found && position < end) {
+                    position = Scan::special(position, end);
+                    if (position >= end)
                         break;
+
+                    if (*position == '\n') {
+                        position++;
+                        found = position >= target;
+                    } else if (*position == '"') {
+                        position = std::min(Scan::find(position + 1, end, '"', lines) + 1, end);
+                    } else if (position + 1 < end && position[1] == '/') {
+                        position = Scan::find(position + 2, end, '\n', lines);
+                    } else if (position + 1 < end && position[1] == '*') {
+                        position = Scan::block_comment_end(position + 2, end, lines);
                     } else {
-                        std::cout << this->filename << ":" << this->line << ":" << this->final_position << ": " 
-                                  << "Found unexpected character \"" << this->source[this->index - 1] << "\"\n";
-                        exit(1);
+                        position++;
                     }
                 }
+
+                if (found && position < end && static_cast<size_t>(position - begin) > output.back().offset)
+                    output.push_back(Boundary{static_cast<size_t>(position - begin)});
             }
+
+            output.push_back(Boundary{source.length()});
+            return output;
         }
 };
 
@@ -0,0 +1,305 @@
+#ifndef LITERAL_HPP
+#define LITERAL_HPP
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+
+#include "token.hpp"
+
+// converts number lexemes into values. integers are kept as an unsigned 128 bit
+// magnitude, which holds every integer type up to u128 (and the magnitude of
+// i128's minimum), the sign comes from a prefix minus in the AST
+namespace Literal {
+
+typedef unsigned __int128 uint128;
+typedef __int128          int128;
+
+struct Integer {
+    uint128 value;
+    bool    overflow;
+    bool    empty = false; // a 0x or 0b with nothing after it
+};
+
+inline int digit_value(char character) {
+    if (character >= '0' && character <= '9') return character - '0';
+    if (character >= 'a' && character <= 'f') return character - 'a' + 10;
+    if (character >= 'A' && character <= 'F') return character - 'A' + 10;
+    return 99;
+}
+
+// the slow path, only for literals that don't fit in 64 bits
+inline Integer parse_wide(std::string_view digits, int base) {
+    uint128 value = 0;
+    uint128 limit = ~static_cast<uint128>(0) / base;
+
+    for (char character : digits) {
+        uint128 digit = digit_value(character);
+        if (value > limit || value * base > ~static_cast<uint128>(0) - digit)
+            return Integer{0, true};
+        value = value * base + digit;
+    }
+
+    return Integer{value, false};
+}
+
+// handles plain decimal as well as 0x and 0b literals, the lexer keeps the prefix in the lexeme
+inline Integer parse_integer(std::string_view lexeme) {
+    int base = 10;
+    size_t marker = lexeme.find_first_of("xb");
+
+    if (marker != std::string_view::npos) {
+        base = lexeme[marker] == 'x' ? 16 : 2;
+        lexeme = lexeme.substr(marker + 1);
+    }
+
+    if (lexeme.empty())
+        return Integer{0, false, true};
+
+    uint64_t narrow = 0;
+    auto [end, error] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.length(), narrow, base);
+
+    if (error == std::errc() && end == lexeme.data() + lexeme.length())
+        return Integer{narrow, false};
+
+    return parse_wide(lexeme, base);
+}
+
+// whether a magnitude and sign are in range for an integer type `bits` wide
+inline bool fits(uint128 magnitude, bool negative, int bits, bool is_signed) {
+    if (negative && magnitude != 0 && !is_signed)
+        return false;
+
+    int room = is_signed ? bits - 1 : bits;
+    uint128 max = room >= 128 ? ~static_cast<uint128>(0) : (static_cast<uint128>(1) << room) - 1;
+
+    // a signed type goes one further on the negative side
+    return magnitude <= max || (negative && is_signed && magnitude - 1 == max);
+}
+
+// brings an exact value into an integer type the way run time will: unsigned
+// types wrap modulo 2^bits, signed ones don't wrap so false means it overflows.
+// the constant folder and the compile time evaluator both go through here
+inline bool narrow(uint128& magnitude, bool& negative, int bits, bool is_signed) {
+    if (is_signed)
+        return fits(magnitude, negative, bits, is_signed);
+
+    uint128 mask = bits >= 128 ? ~static_cast<uint128>(0) : (static_cast<uint128>(1) << bits) - 1;
+
+    // -m is 2^128 - m modulo 2^128, and so modulo any smaller power of two
+    if (negative)
+        magnitude = ~magnitude + 1;
+
+    magnitude &= mask;
+    negative = false;
+    return true;
+}
+
+// the range of a number type, by its keyword
+struct Width {
+    int  bits      = 0; // 0 for anything that isn't a number type
+    bool is_signed = true;
+    bool floating  = false;
+};
+
+inline Width width_of(TokenType keyword) {
+    switch (keyword) {
+        case TokenType::INT8:        return Width{8, true};
+        case TokenType::INT16:       return Width{16, true};
+        case TokenType::INT32:       return Width{32, true};
+        case TokenType::INT_TYPE:
+        case TokenType::INT64:       return Width{64, true};
+        case TokenType::INT128:      return Width{128, true};
+        case TokenType::UINT8:       return Width{8, false};
+        case TokenType::UINT16:      return Width{16, false};
+        case TokenType::UINT32:      return Width{32, false};
+        case TokenType::UINT64:      return Width{64, false};
+        case TokenType::UINT128:     return Width{128, false};
+        case TokenType::FLOAT_TYPE:  return Width{32, true, true};
+        case TokenType::DOUBLE_TYPE: return Width{64, true, true};
+        default:                     return Width{};
+    }
+}
+
+// the keyword of a number type the way a node keeps it in `op`, NO_TYPE for none
+constexpr uint8_t NO_TYPE = UINT8_MAX;
+
+inline Width width_of_annotation(uint8_t keyword) {
+    return keyword == NO_TYPE ? Width{} : width_of(static_cast<TokenType>(keyword));
+}
+
+inline bool arithmetic(TokenType op) {
+    return op == TokenType::PLUS || op == TokenType::MINUS || op == TokenType::MULT || op == TokenType::DIV;
+}
+
+// an integer as sign and magnitude, which covers everything from i128's minimum
+// to u128's maximum. zero is never negative
+struct Number {
+    uint128 magnitude = 0;
+    bool    negative  = false;
+};
+
+inline bool in_width(Number value, Width width) {
+    return fits(value.magnitude, value.negative, width.bits, width.is_signed);
+}
+
+// +, -, * or / on sign and magnitude, false if the magnitude leaves 128 bits.
+// the result is still right modulo 2^128 then, which is all a wrapping type needs
+inline bool exact_step(TokenType op, Number left, Number right, Number& result) {
+    result = Number{};
+    bool exact = true;
+
+    switch (op) {
+
+        case TokenType::MINUS:
+            right.negative = !right.negative && right.magnitude != 0;
+            [[fallthrough]];
+
+        case TokenType::PLUS: {
+            if (left.negative == right.negative) {
+                result.negative = left.negative;
+                exact = !__builtin_add_overflow(left.magnitude, right.magnitude, &result.magnitude);
+            } else if (left.magnitude >= right.magnitude) {
+                result.negative = left.negative;
+                result.magnitude = left.magnitude - right.magnitude;
+            } else {
+                result.negative = right.negative;
+                result.magnitude = right.magnitude - left.magnitude;
+            }
+            break;
+        }
+
+        case TokenType::MULT: {
+            result.negative = left.negative != right.negative;
+            exact = !__builtin_mul_overflow(left.magnitude, right.magnitude, &result.magnitude);
+            break;
+        }
+
+        // truncates towards zero, the caller has ruled out dividing by it
+        default: {
+            result.negative = left.negative != right.negative;
+            result.magnitude = left.magnitude / right.magnitude;
+            break;
+        }
+
+    }
+
+    result.negative = result.negative && result.magnitude != 0;
+    return exact;
+}
+
+enum class Step : uint8_t {
+    DONE,
+    OUT_OF_RANGE, // of a signed type, or of 128 bits without one
+    BY_ZERO,
+    UNKNOWN,      // a quotient of values that aren't in the type yet
+};
+
+// one step of integer arithmetic the way `width` does it at run time: unsigned
+// types wrap after every step and signed ones have to fit. without a type, or
+// with a float one, it only has to fit in 128 bits
+inline Step step(TokenType op, Number left, Number right, Width width, Number& result) {
+    if (width.floating)
+        width = Width{};
+
+    if (op == TokenType::DIV && right.magnitude == 0)
+        return Step::BY_ZERO;
+
+    // wrapping doesn't commute with division, so a quotient is only worked out
+    // once both sides are values of the type
+    if (op == TokenType::DIV && width.bits != 0 && (!in_width(left, width) || !in_width(right, width)))
+        return Step::UNKNOWN;
+
+    bool exact = exact_step(op, left, right, result);
+
+    if (width.bits != 0 && !width.is_signed) {
+        narrow(result.magnitude, result.negative, width.bits, false);
+        return Step::DONE;
+    }
+
+    if (!exact || (width.bits != 0 && !narrow(result.magnitude, result.negative, width.bits, true)))
+        return Step::OUT_OF_RANGE;
+
+    return Step::DONE;
+}
+
+// the same for floats, rounded after every step when the type is a float
+inline double step(TokenType op, double left, double right, Width width) {
+    double value;
+
+    switch (op) {
+        case TokenType::PLUS:  value = left + right; break;
+        case TokenType::MINUS: value = left - right; break;
+        case TokenType::MULT:  value = left * right; break;
+        default:               value = left / right; break;
+    }
+
+    return width.floating && width.bits == 32 ? static_cast<float>(value) : value;
+}
+
+// -1, 0 or 1, or 2 when they're unordered
+inline int order(Number left, Number right) {
+    if (left.negative != right.negative)
+        return left.negative ? -1 : 1;
+
+    int order = left.magnitude < right.magnitude ? -1 : left.magnitude > right.magnitude ? 1 : 0;
+    return left.negative ? -order : order;
+}
+
+// nan isn't equal, less or greater than anything
+inline int order(double left, double right) {
+    return left < right ? -1 : left > right ? 1 : left == right ? 0 : 2;
+}
+
+// whether comparison `op` holds between two values `order` apart. false when
+// `op` isn't a comparison
+inline bool compares(TokenType op, int order, bool& holds) {
+    switch (op) {
+        case TokenType::EQUAL_EQUAL: holds = order == 0; return true;
+        case TokenType::NOT_EQUAL:   holds = order != 0; return true;
+        case TokenType::LT:          holds = order == -1; return true;
+        case TokenType::LT_EQUALS:   holds = order == -1 || order == 0; return true;
+        case TokenType::GT:          holds = order == 1; return true;
+        case TokenType::GT_EQUALS:   holds = order == 1 || order == 0; return true;
+        default:                     return false;
+    }
+}
+
+struct Float {
+    double value;
+    bool   overflow;
+};
+
+// there's no exponent, so a literal is only out of range past the top when
+// it has a whole part. one too small to tell from zero is just zero
+inline Float parse_float(std::string_view lexeme) {
+    double value = 0;
+    auto [end, error] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.length(), value);
+
+    if (error == std::errc::result_out_of_range)
+        return Float{0, lexeme.find_first_not_of('0') < lexeme.find('.')};
+
+    return Float{value, false};
+}
+
+inline std::string to_string(uint128 value) {
+    if (value == 0)
+        return "0";
+
+    char buffer[40];
+    char* position = buffer + sizeof(buffer);
+
+    while (value != 0) {
+        *--position = '0' + static_cast<int>(value % 10);
+        value /= 10;
+    }
+
+    return std::string(position, buffer + sizeof(buffer));
+}
+
+}
+
+#endif
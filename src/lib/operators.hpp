@@ -0,0 +1,144 @@
+#ifndef OPERATORS_HPP
+#define OPERATORS_HPP
+
+#pragma once
+
+#include <string_view>
+#include <array>
+#include <cstdint>
+
+#include "token.hpp"
+#include "chars.hpp"
+
+namespace Operators {
+
+struct Operator {
+    std::string_view text;
+    TokenType        token_type;
+};
+
+// every operator and punctuation token. the lexer's operator DFA is generated
+// from this at compile time, so a new operator is one more line here
+constexpr Operator list[] = {
+    {".",  TokenType::DOT        },
+    {"..", TokenType::VARIADIC   },
+    {"+",  TokenType::PLUS       },
+    {"++", TokenType::PLUS_PLUS  },
+    {"-",  TokenType::MINUS      },
+    {"--", TokenType::MINUS_MINUS},
+    {"@",  TokenType::AT         },
+    {"/",  TokenType::DIV        },
+    {"*",  TokenType::MULT       },
+    {"**", TokenType::MULT_MULT  },
+    {"<",  TokenType::LT         },
+    {"<<", TokenType::SHL        },
+    {"<=", TokenType::LT_EQUALS  },
+    {">",  TokenType::GT         },
+    {">>", TokenType::SHR        },
+    {">=", TokenType::GT_EQUALS  },
+    {"=",  TokenType::EQUAL      },
+    {"==", TokenType::EQUAL_EQUAL},
+    {"&",  TokenType::AMPERSAND  },
+    {";",  TokenType::SEMICOLON  },
+    {":",  TokenType::COLON      },
+    {"::", TokenType::SCOPE      },
+    {"#",  TokenType::HASH       },
+    {",",  TokenType::COMMA      },
+    {"|",  TokenType::PIPE       },
+    {"!",  TokenType::BANG       },
+    {"!=", TokenType::NOT_EQUAL  },
+    {"?",  TokenType::QUESTION   },
+    {"(",  TokenType::L_PAREN    },
+    {")",  TokenType::R_PAREN    },
+    {"{",  TokenType::L_BRACE    },
+    {"}",  TokenType::R_BRACE    },
+    {"[",  TokenType::L_SQUARE   },
+    {"]",  TokenType::R_SQUARE   },
+};
+
+constexpr size_t count_characters(void) {
+    size_t count = 0;
+    for (const Operator& op : list)
+        count += op.text.length();
+    return count;
+}
+
+// one state per distinct prefix can't need more than one per character plus the start state
+constexpr size_t MAX_STATES = count_characters() + 1;
+constexpr size_t MAX_COLUMNS = count_characters() + 1;
+
+constexpr uint8_t NO_TOKEN = UINT8_MAX;
+
+static_assert(MAX_STATES <= UINT8_MAX, "too many operator states for uint8_t transitions");
+
+// state 0 is the start state, and a transition to 0 means there's no way on.
+// bytes are squeezed into columns first so the table stays a couple of KB
+struct Machine {
+    std::array<uint8_t, 256>                                  columns;
+    std::array<std::array<uint8_t, MAX_COLUMNS>, MAX_STATES> next;
+    std::array<uint8_t, MAX_STATES>                           accept;
+
+    bool valid;
+};
+
+constexpr Machine build_machine(void) {
+    Machine machine = {};
+    machine.valid = true;
+
+    for (uint8_t& accept : machine.accept)
+        accept = NO_TOKEN;
+
+    uint8_t columns = 1;
+    uint8_t states = 1;
+
+    for (const Operator& op : list) {
+        uint8_t state = 0;
+
+        for (char character : op.text) {
+            uint8_t& column = machine.columns[static_cast<uint8_t>(character)];
+            if (column == 0)
+                column = columns++;
+
+            uint8_t& next = machine.next[state][column];
+            if (next == 0)
+                next = states++;
+
+            state = next;
+        }
+
+        // the same operator twice, or one the lexer would never get to because
+        // Chars doesn't know its first character starts an operator
+        if (machine.accept[state] != NO_TOKEN || !(Chars::table[static_cast<uint8_t>(op.text[0])] & Chars::OPERATOR))
+            machine.valid = false;
+
+        machine.accept[state] = op.token_type;
+    }
+
+    return machine;
+}
+
+constexpr Machine machine = build_machine();
+
+static_assert(machine.valid, "operator list has a duplicate, or an operator whose first character isn't in Chars::operator_characters");
+
+inline uint8_t step(uint8_t state, char character) {
+    return machine.next[state][machine.columns[static_cast<uint8_t>(character)]];
+}
+
+constexpr std::array<std::string_view, UINT8_MAX + 1> build_spellings(void) {
+    std::array<std::string_view, UINT8_MAX + 1> spellings = {};
+    for (const Operator& op : list)
+        spellings[op.token_type] = op.text;
+    return spellings;
+}
+
+constexpr std::array<std::string_view, UINT8_MAX + 1> spellings = build_spellings();
+
+// the text of an operator token, which is always the same as its lexeme
+inline std::string_view spelling(TokenType token_type) {
+    return spellings[token_type];
+}
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef OUTPUT_HPP
+#define OUTPUT_HPP
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string_view>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+// buffered writes to a FILE. everything goes through one fixed buffer that's
+// handed to fwrite once it fills up, so output costs a memcpy per piece
+class Output {
+    static constexpr size_t SIZE = 1 << 16;
+
+    FILE*                   file;
+    std::unique_ptr<char[]> buffer = std::unique_ptr<char[]>(new char[SIZE]);
+    size_t                  used   = 0;
+
+    public:
+        explicit Output(FILE* file) : file(file) {}
+
+        Output(const Output&) = delete;
+        Output& operator=(const Output&) = delete;
+
+        ~Output() {
+            this->flush();
+        }
+
+        void flush(void) {
+            if (this->used > 0)
+                std::fwrite(this->buffer.get(), 1, this->used, this->file);
+
+            this->used = 0;
+            std::fflush(this->file);
+        }
+
+        void write(const char* data, size_t length) {
+            if (length == 0)
+                return;
+
+            if (this->used + length > SIZE) {
+                std::fwrite(this->buffer.get(), 1, this->used, this->file);
+                this->used = 0;
+
+                if (length > SIZE) {
+                    std::fwrite(data, 1, length, this->file);
+                    return;
+                }
+            }
+
+            std::memcpy(this->buffer.get() + this->used, data, length);
+            this->used += length;
+        }
+
+        void write(std::string_view text) {
+            this->write(text.data(), text.length());
+        }
+
+        void put(char character) {
+            if (this->used == SIZE)
+                this->write(&character, 1);
+            else
+                this->buffer[this->used++] = character;
+        }
+
+        void spaces(size_t count) {
+            static const char blank[64] = {
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+            };
+
+            for (; count > sizeof(blank); count -= sizeof(blank))
+                this->write(blank, sizeof(blank));
+            this->write(blank, count);
+        }
+
+        void number(double value) {
+            char digits[32];
+            int length = std::snprintf(digits, sizeof(digits), "%g", value);
+            this->write(digits, length);
+        }
+
+        void number(uint64_t value) {
+            char digits[24];
+            int length = std::snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(value));
+            this->write(digits, length);
+        }
+
+        // the bytes of a trivially copyable value, as they are in memory
+        template<typename T>
+        void raw(const T& value) {
+            this->write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        void raw(const std::vector<T>& values) {
+            this->raw(static_cast<uint32_t>(values.size()));
+            this->write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        }
+};
+
+#endif
@@ -5,76 +5,327 @@
 
 #include <vector>
 #include <string>
-#include <memory>
+#include <array>
 
 #include "token.hpp"
-#include "expr.hpp"
+#include "lexer.hpp"
+#include "ast.hpp"
 #include "errors.hpp"
 
 #define TYPES TokenType::NUMBER, TokenType::INT8, TokenType::INT16, TokenType::INT32, TokenType::INT64, TokenType::INT128, \
               TokenType::UINT, TokenType::UINT8, TokenType::UINT16, TokenType::UINT32, TokenType::UINT64, TokenType::UINT128, \
               TokenType::FLOAT_TYPE, TokenType::DOUBLE_TYPE, TokenType::BOOL_TYPE, TokenType::STR, TokenType::INT_TYPE
 
+// binding powers for the expression parser, weakest first. everything here is
+// built at compile time
+namespace Precedence {
+
+enum Power : uint8_t {
+    NONE       = 0,
+    EQUALITY   = 1,
+    COMPARISON = 2,
+    TERM       = 3,
+    FACTOR     = 4,
+    RANGE      = 5,
+    POSTFIX    = 6,
+
+    LOWEST     = EQUALITY,
+};
+
+struct Operator {
+    TokenType token_type;
+    Power     power;
+};
+
+constexpr Operator binary[] = {
+    {TokenType::EQUAL_EQUAL, EQUALITY  },
+    {TokenType::NOT_EQUAL,   EQUALITY  },
+    {TokenType::GT,          COMPARISON},
+    {TokenType::GT_EQUALS,   COMPARISON},
+    {TokenType::LT,          COMPARISON},
+    {TokenType::LT_EQUALS,   COMPARISON},
+    {TokenType::PLUS,        TERM      },
+    {TokenType::MINUS,       TERM      },
+    {TokenType::MULT,        FACTOR    },
+    {TokenType::DIV,         FACTOR    },
+    {TokenType::VARIADIC,    RANGE     },
+};
+
+constexpr std::array<Power, UINT8_MAX + 1> build_infix(void) {
+    std::array<Power, UINT8_MAX + 1> table = {};
+    for (const Operator& op : binary)
+        table[op.token_type] = op.power;
+    return table;
+}
+
+// binding power of every token used as a binary operator, NONE for the rest
+constexpr std::array<Power, UINT8_MAX + 1> infix = build_infix();
+
+constexpr TokenSet prefix  = {TokenType::MULT, TokenType::AMPERSAND, TokenType::MINUS, TokenType::VARIADIC, TokenType::PLUS_PLUS, TokenType::MINUS_MINUS, TokenType::HASH};
+constexpr TokenSet postfix = {TokenType::PLUS_PLUS, TokenType::MINUS_MINUS, TokenType::QUESTION, TokenType::BANG};
+
+}
+
+// thrown once a syntax error has been reported, and caught at the nearest place
+// a declaration or statement can start over
+struct ParseError {};
+
+// keywords that can only start a top level declaration, never a statement
+constexpr TokenSet declarations = {
+    TokenType::TYPE, TokenType::INTERFACE, TokenType::FUNC, TokenType::STRUCT, TokenType::ENUM, TokenType::IMPORT,
+};
+
+// where panic mode stops skipping, besides just past a ';' or just before a '}'
+constexpr TokenSet sync_points = {
+    TokenType::TYPE, TokenType::INTERFACE, TokenType::FUNC, TokenType::STRUCT, TokenType::ENUM, TokenType::IMPORT,
+    TokenType::LET, TokenType::CONST, TokenType::IF, TokenType::WHILE, TokenType::FOR, TokenType::RETURN, TokenType::THROW,
+};
+
 class Parser {
-    std::vector<std::shared_ptr<Token>> tokens;
-    std::vector<std::string> lines;
+    TokenStream tokens;
+
+    // every node goes in here, the parser only hands out indices into it
+    Ast& ast;
+
+    Diagnostics& diagnostics;
+
+    // child lists are built up on here and copied into the AST in one go once
+    // they're complete, nested lists just stack on top
+    std::vector<NodeId> stack;
+
+    // a suspended step of the expression parser, see run(). `node` is what the
+    // step has so far (the left side, the callee, the scope root...) or NO_NODE,
+    // `loc` is where its operator or opening token is
+    struct Frame {
+        enum Kind : uint8_t {
+            BINARY,
+            PREFIX,
+            ASSIGN,
+            SCOPE,
+            CALL,
+            GROUPING,
+        };
+
+        Kind              kind;
+        Precedence::Power op_power = Precedence::NONE;
+        uint8_t           op       = 0;
+        SourceLoc         loc      = {};
+        NodeId            node     = NO_NODE;
+        uint32_t          mark     = 0;
+    };
+
+    enum class Descend {
+        UNARY,
+        TYPE,
+        CALL,
+    };
+
+    std::vector<Frame> frames;
+
+    // a statement that's still waiting on the one inside it, see nest(). blocks
+    // and if/else chains stack up in here instead of on the native stack too.
+    // `first`, `second` and `third` are the parts parsed so far in the order
+    // the node takes them. a BLOCK keeps where its statements start on `stack`,
+    // and where the one it's parsing now started so that one can be recovered from
+    struct Nest {
+        enum Kind : uint8_t {
+            BLOCK,
+            IF,
+            ELSE,
+            WHILE,
+            C_FOR,
+            FINN_FOR,
+        };
+
+        Kind      kind;
+        SourceLoc loc;
+        NodeId    first  = NO_NODE;
+        NodeId    second = NO_NODE;
+        NodeId    third  = NO_NODE;
+        uint32_t  types  = Ast::EMPTY_LIST;
+        size_t    mark   = 0;
+        size_t    top    = 0;
+        int       start  = 0;
+    };
+
+    std::vector<Nest> nests;
+
+    // with lazy bodies on, func() only brace matches its way past the body and
+    // leaves a LAZY_BODY behind, which body() parses when somebody needs it.
+    // that takes a buffered token stream, a streaming one can't go back
+    bool                lazy_bodies;
+    std::vector<NodeId> lazy_funcs;
 
     int index = 0;
 
     public:
-        Parser(std::vector<std::shared_ptr<Token>> tokens, std::vector<std::string> lines) 
-          : tokens(tokens), lines(lines) {
+        Parser(TokenStream tokens, Ast& ast, Diagnostics& diagnostics, bool lazy_bodies = false) 
+          : tokens(std::move(tokens)), ast(ast), diagnostics(diagnostics) {
             this->index = index;
+            this->lazy_bodies = lazy_bodies && this->tokens.buffered();
         }
 
         ~Parser() = default;
 
-        std::vector<std::shared_ptr<Stmt::Stmt>> parse(void) {
-            std::vector<std::shared_ptr<Stmt::Stmt>> statements = {};
-            while (!this->at_end())
-                statements.push_back(std::move(this->declaration()));
+        // declarations with syntax errors in them are reported and left out. it
+        // stops early once the diagnostics are full
+        std::vector<NodeId> parse(void) {
+            std::vector<NodeId> statements = {};
+
+            try {
+                while (!this->at_end()) {
+                    NodeId declaration = this->recover(&Parser::declaration);
+                    if (declaration != NO_NODE)
+                        statements.push_back(declaration);
+                }
+            } catch (const ParseError&) {}
+
             return statements;
         }
 
+        // the body of a function, parsed now if it was skipped. syntax errors in
+        // it are reported then, and it's left as an empty block
+        NodeId body(NodeId func) {
+            NodeId body = this->ast.body(func);
+            if (this->ast.get(body).kind != NodeKind::LAZY_BODY)
+                return body;
+
+            int resume = this->index;
+            this->index = this->ast.get(body).first;
+
+            NodeId block = NO_NODE;
+            try {
+                block = this->recover(&Parser::block);
+            } catch (const ParseError&) {}
+
+            if (block == NO_NODE)
+                block = this->ast.add_block(this->ast.loc(body), Ast::EMPTY_LIST);
+
+            this->index = resume;
+            this->ast.set_body(func, block);
+            return block;
+        }
+
+        // every body that was skipped, in source order
+        void parse_bodies(void) {
+            for (NodeId func : this->lazy_funcs) {
+                if (this->diagnostics.full())
+                    break;
+                this->body(func);
+            }
+        }
+
+        size_t lazy_count(void) const { return this->lazy_funcs.size(); }
+
     private:
-        bool at_end(void) {
-            return this->tokens[this->index]->token_type == TokenType::END_OF_FILE;
+        // runs one production, and if it hits a syntax error skips ahead to where
+        // the next one probably starts and returns NO_NODE. once the diagnostics
+        // are full the error is passed on so everything unwinds
+        NodeId recover(NodeId (Parser::*production)(void)) {
+            int start = this->index;
+            size_t stack_mark = this->stack.size();
+            size_t frames_mark = this->frames.size();
+            size_t nests_mark = this->nests.size();
+
+            try {
+                return (this->*production)();
+            } catch (const ParseError&) {
+                if (this->diagnostics.full())
+                    throw;
+
+                this->stack.resize(stack_mark);
+                this->frames.resize(frames_mark);
+                this->nests.resize(nests_mark);
+                this->synchronize();
+
+                // always get past at least one token, or the caller would just fail on it again
+                if (this->index == start && !this->at_end())
+                    this->index++;
+
+                return NO_NODE;
+            }
         }
 
-        bool match(std::vector<TokenType> token_types) {
-            for (TokenType &token_type : token_types) {
-                if (token_type == this->peek()->token_type) {
-                    this->advance();
-                    return true;
+        // skips whole brace groups on the way, so a broken declaration's body
+        // goes with it instead of being parsed on its own
+        void synchronize(void) {
+            size_t depth = 0;
+
+            while (!this->at_end()) {
+                TokenType current = this->tokens.kind(this->index);
+
+                if (current == TokenType::L_BRACE) {
+                    depth++;
+                } else if (current == TokenType::R_BRACE) {
+                    if (depth == 0)
+                        return;
+
+                    if (--depth == 0) {
+                        this->index++;
+                        return;
+                    }
+                } else if (depth == 0) {
+                    if (current == TokenType::SEMICOLON) {
+                        this->index++;
+                        return;
+                    }
+
+                    if (sync_points.has(current))
+                        return;
                 }
-            } return false;
+
+                this->index++;
+            }
+        }
+
+        [[noreturn]] void error(std::string message, Token token) {
+            this->diagnostics.report(std::move(message), token);
+            throw ParseError();
+        }
+
+        uint32_t collect(std::vector<NodeId>& stack, size_t mark) {
+            uint32_t list = this->ast.add_list(stack.data() + mark, stack.size() - mark);
+            stack.resize(mark);
+            return list;
+        }
+
+        bool at_end(void) {
+            return this->tokens.kind(this->index) == TokenType::END_OF_FILE;
+        }
+
+        bool match(const TokenSet& token_types) {
+            if (!token_types.has(this->tokens.kind(this->index)))
+                return false;
+
+            this->index++;
+            return true;
         }
 
-        std::shared_ptr<Token> advance(void) {
-            std::shared_ptr<Token> token = this->tokens[this->index];
+        Token advance(void) {
+            Token token = this->tokens.get(this->index);
             this->index++;
             return token;
         }
 
-        std::shared_ptr<Token> peek(void) {
-            return this->tokens[this->index];
+        Token peek(void) {
+            return this->tokens.get(this->index);
+        }
+
+        Token previous(void) {
+            return this->tokens.get(this->index - 1);
         }
 
-        std::shared_ptr<Token> previous(void) {
-            return this->tokens[this->index - 1];
+        SourceLoc loc_of(size_t index) {
+            return this->tokens.loc(index);
         }
 
         void consume(TokenType expected, std::string message) {
-            if (!this->match({expected})) {
-                Error* error = new Error(message, this->lines, this->previous());
-                error->print();
-                delete error;
-                exit(1);
-            }
+            if (!this->match({expected}))
+                this->error(message, this->previous());
         }
 
-        std::shared_ptr<Stmt::Stmt> declaration(void) {
-            switch (this->peek()->token_type) {
+        NodeId declaration(void) {
+            switch (this->tokens.kind(this->index)) {
 
                 case TokenType::TYPE: {
                     this->advance();
@@ -113,123 +364,128 @@ class Parser {
             }
         }
 
-        std::shared_ptr<Stmt::Stmt> interface(void) {
-            std::shared_ptr<Token> name = this->advance();
+        NodeId interface(void) {
+            Token name = this->advance();
             this->consume(TokenType::L_BRACE, "Expected opening brace in interface definition");
-            std::vector<std::shared_ptr<Stmt::Stmt>> body = {};
-
-            while (!this->match({TokenType::R_BRACE}))
-                body.push_back(this->declaration());
+            size_t body = this->stack.size();
 
-            return std::make_shared<Stmt::Interface>(Stmt::Interface(std::move(name), body));
-        }
-
-        std::shared_ptr<Stmt::Stmt> type(void) {
-            std::shared_ptr<Stmt::Stmt> body;
+            while (!this->match({TokenType::R_BRACE})) {
+                if (this->at_end())
+                    this->error("Expected closing brace in interface definition", this->previous());
 
-            if (this->match({TokenType::STRUCT}))
-                body = this->_struct();
+                NodeId member = this->recover(&Parser::declaration);
+                if (member != NO_NODE)
+                    this->stack.push_back(member);
+            }
 
-            else if (this->match({TokenType::IDENT})) {
+            return this->ast.add_interface(name.loc(), Interner::intern(name.lexeme), this->collect(this->stack, body));
+        }
 
-            }
+        // there's no node for a type declaration yet, so it can't be parsed into anything
+        NodeId type(void) {
+            this->error("Type declarations are not implemented yet", this->previous());
         }
 
-        std::shared_ptr<Stmt::Stmt> import(void) {
-            std::shared_ptr<Expr::Expr> module = this->scope();
+        NodeId import(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
+            NodeId module = this->scope();
             this->consume(TokenType::SEMICOLON, "Expected semicolon at the end of statement");
-            return std::make_shared<Stmt::Import>(Stmt::Import(std::move(module)));
+            return this->ast.add_import(keyword, module);
         }
 
-        std::shared_ptr<Stmt::Stmt> _enum(void) {
-            std::shared_ptr<Token> enum_name = this->advance();
-            std::vector<std::shared_ptr<Expr::Expr>> types = {};
-            std::vector<std::shared_ptr<Stmt::Stmt>> body = {};
+        NodeId _enum(void) {
+            Token enum_name = this->advance();
+            size_t types_mark = this->stack.size();
+            size_t body = this->stack.size();
 
             if (this->match({TokenType::COLON})) {
-                types.push_back(this->scope());
+                this->stack.push_back(this->scope());
 
                 while (this->match({TokenType::COMMA}))
-                    types.push_back(this->scope());
+                    this->stack.push_back(this->scope());
             }
 
+            uint32_t types = this->collect(this->stack, types_mark);
+
             this->consume(TokenType::L_BRACE, "Expected opening brace in enum definition");
             if (this->match({TokenType::IDENT})) {
-                std::shared_ptr<Token> name = this->previous();
-                std::shared_ptr<Expr::Expr> value = nullptr;
+                Token name = this->previous();
+                NodeId value = NO_NODE;
 
                 if (this->match({TokenType::EQUAL}))
-                    value = this->equality();
+                    value = this->binary();
 
-                body.push_back(std::make_shared<Stmt::Mutable>(Stmt::Mutable(std::move(name), types, std::move(value))));
+                this->stack.push_back(this->ast.add_mutable(name.loc(), Interner::intern(name.lexeme), types, value));
 
 
                 while (this->match({TokenType::COMMA})) {
-                    std::shared_ptr<Token> name = this->advance();
-                    std::shared_ptr<Expr::Expr> value = nullptr;
+                    Token name = this->advance();
+                    NodeId value = NO_NODE;
 
                     if (this->match({TokenType::EQUAL}))
-                        value = this->equality();
+                        value = this->binary();
 
-                    body.push_back(std::make_shared<Stmt::Mutable>(Stmt::Mutable(std::move(name), types, std::move(value))));
+                    this->stack.push_back(this->ast.add_mutable(name.loc(), Interner::intern(name.lexeme), types, value));
                 }
             }
             this->consume(TokenType::R_BRACE, "Expected closing brace in enum definition");
 
 
-            return std::make_shared<Stmt::Enum>(Stmt::Enum(std::move(enum_name), types, std::move(body)));
+            return this->ast.add_enum(enum_name.loc(), Interner::intern(enum_name.lexeme), types, this->collect(this->stack, body));
         }
 
-        std::shared_ptr<Stmt::Stmt> _struct(void) {
-            std::shared_ptr<Token> name = this->advance();
+        NodeId _struct(void) {
+            Token name = this->advance();
 
-            if (this->match({TokenType::LT})) {
-                std::cout << "Struct generics are not implemented yet.";
-                exit(1);
-            }
+            if (this->match({TokenType::LT}))
+                this->error("Struct generics are not implemented yet", this->previous());
 
             this->consume(TokenType::L_BRACE, "Expected opening brace in struct definition");
 
-            std::vector<std::shared_ptr<Stmt::Stmt>> members = {};
+            size_t members = this->stack.size();
 
             if (this->match({TokenType::IDENT})) {
                 this->index--;
-                members.push_back(this->arg());
+                this->stack.push_back(this->arg());
 
                 while (this->match({TokenType::COMMA})) 
-                    members.push_back(this->arg());
+                    this->stack.push_back(this->arg());
                 
             }
 
             this->consume(TokenType::R_BRACE, "Expected closing brace in struct definition");
 
-            return std::make_shared<Stmt::Struct>(Stmt::Struct(std::move(name), members));
+            return this->ast.add_struct(name.loc(), Interner::intern(name.lexeme), this->collect(this->stack, members));
         }
 
-        std::shared_ptr<Stmt::Stmt> func(void) {
-            std::shared_ptr<Expr::Expr> name = this->literal();
+        NodeId func(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
+            NodeId name = this->literal();
 
             while (!this->match({TokenType::L_PAREN, TokenType::LT}) && this->match({TokenType::DOT})) {
-                name = std::make_shared<Expr::Scope>(Expr::Scope(std::move(name), this->literal()));
+                SourceLoc dot = this->loc_of(this->index - 1);
+                name = this->ast.add_scope(dot, name, this->literal());
             } this->index--;
 
-            std::vector<std::shared_ptr<Stmt::Stmt>> args = {};
+            uint32_t args = Ast::EMPTY_LIST;
 
-            std::vector<std::shared_ptr<Expr::Expr>> return_types = {};
-            std::vector<std::shared_ptr<Expr::Expr>> throw_types = {};
+            uint32_t return_types = Ast::EMPTY_LIST;
+            uint32_t throw_types = Ast::EMPTY_LIST;
 
-            if (this->match({TokenType::LT})) {
-                std::cout << "TODO: Function generics are not implemented yet\n";
-                exit(1);
-            }
+            if (this->match({TokenType::LT}))
+                this->error("Function generics are not implemented yet", this->previous());
 
             this->consume(TokenType::L_PAREN, "Expected opening parenthesis in function declaration");
 
             if (this->match({TokenType::IDENT})) {
+                size_t mark = this->stack.size();
+
                 this->index--;
-                args.push_back(std::move(this->arg()));
+                this->stack.push_back(this->arg());
                 while (this->match({TokenType::COMMA}))
-                    args.push_back(std::move(this->arg()));
+                    this->stack.push_back(this->arg());
+
+                args = this->collect(this->stack, mark);
             }
 
             this->consume(TokenType::R_PAREN, "Expected closing parenthesis in function declaration");
@@ -237,64 +493,124 @@ class Parser {
             if (this->match({TokenType::COLON})) {
 
                 if (this->match({TokenType::IDENT, TYPES})) {
+                    size_t mark = this->stack.size();
                     this->index--;
 
-                    return_types.push_back(this->scope());
+                    this->stack.push_back(this->scope());
 
                     while (this->match({TokenType::PIPE}))
-                        return_types.push_back(this->scope());
+                        this->stack.push_back(this->scope());
+
+                    return_types = this->collect(this->stack, mark);
                 }                
 
                 if (this->match({TokenType::QUESTION})) {
-                    throw_types.push_back(this->scope());
+                    size_t mark = this->stack.size();
+
+                    this->stack.push_back(this->scope());
 
                     while (this->match({TokenType::PIPE}))
-                        throw_types.push_back(this->scope());
+                        this->stack.push_back(this->scope());
+
+                    throw_types = this->collect(this->stack, mark);
                 }
             }
 
             this->consume(TokenType::L_BRACE, "guh");
-            std::shared_ptr<Stmt::Stmt> body = this->block();
 
-            return std::make_shared<Stmt::Func>(std::move(name), args, return_types, throw_types, std::move(body));
+            if (this->lazy_bodies) {
+                NodeId func = this->ast.add_func(keyword, name, args, return_types, throw_types, this->skip_body());
+                if (this->ast.get(this->ast.body(func)).kind == NodeKind::LAZY_BODY)
+                    this->lazy_funcs.push_back(func);
+                return func;
+            }
+
+            NodeId body = this->block();
+
+            return this->ast.add_func(keyword, name, args, return_types, throw_types, body);
+        }
+
+        // jumps to the '}' matching the one just consumed by looking at nothing
+        // but token kinds. where block() would give up, on a missing brace, it
+        // goes back and parses the body for real so the errors come out the same
+        NodeId skip_body(void) {
+            SourceLoc brace = this->loc_of(this->index - 1);
+            uint32_t begin = this->index;
+            size_t depth = 0;
+
+            while (true) {
+                TokenType current = this->tokens.kind(this->index);
+
+                if (current == TokenType::END_OF_FILE || declarations.has(current)) {
+                    this->index = begin;
+                    return this->block();
+                }
+
+                if (current == TokenType::L_BRACE)
+                    depth++;
+                else if (current == TokenType::R_BRACE && depth-- == 0)
+                    break;
+
+                this->index++;
+            }
+
+            return this->ast.add_lazy_body(brace, begin, this->index++);
         }
 
-        std::shared_ptr<Stmt::Stmt> arg(void) {
-            std::shared_ptr<Token> name = this->advance();
-            std::vector<std::shared_ptr<Expr::Expr>> types = {};
-            std::shared_ptr<Expr::Expr> body = nullptr;
+        NodeId arg(void) {
+            Token name = this->advance();
+            size_t mark = this->stack.size();
+            NodeId body = NO_NODE;
 
             this->consume(TokenType::COLON, "Expected colon in arg definition");
 
-            types.push_back(this->prefix());
+            this->stack.push_back(this->annotation());
             while (this->match({TokenType::PIPE})) 
-                types.push_back(this->prefix());
+                this->stack.push_back(this->annotation());
+
+            uint32_t types = this->collect(this->stack, mark);
             
             if (this->match({TokenType::EQUAL}))
-                body = this->equality();
+                body = this->binary();
 
-            if (body == nullptr)
-                return std::make_shared<Stmt::Mutable>(Stmt::Mutable(std::move(name), types, std::make_shared<Expr::Nil>(Expr::Nil())));
+            if (body == NO_NODE)
+                return this->ast.add_mutable(name.loc(), Interner::intern(name.lexeme), types, this->ast.add_nil(SourceLoc{}));
             else
-                return std::make_shared<Stmt::Mutable>(Stmt::Mutable(std::move(name), types, std::move(body)));
+                return this->ast.add_mutable(name.loc(), Interner::intern(name.lexeme), types, body);
         }
 
-        std::shared_ptr<Stmt::Stmt> control_flow(void) {
-            switch (this->peek()->token_type) {
+        NodeId control_flow(void) {
+            return this->nest(this->nests.size(), this->statement());
+        }
+
+        // the '{' has been consumed already
+        NodeId block(void) {
+            size_t base = this->nests.size();
+            this->open_block();
+            return this->nest(base, NO_NODE);
+        }
+
+        // a whole statement, or NO_NODE once it's pushed a Nest for one that needs
+        // another statement inside it before it's done
+        NodeId statement(void) {
+            switch (this->tokens.kind(this->index)) {
 
                 case TokenType::FOR: {
                     this->advance();
-                    return std::move(this->for_loop());
+                    this->for_loop();
+                    return NO_NODE;
                 }
 
                 case TokenType::WHILE: {
                     this->advance();
-                    return std::move(this->while_loop());
+                    this->while_loop();
+                    return NO_NODE;
                 }
 
                 case TokenType::IF: {
                     this->advance();
-                    return std::move(this->if_else());
+                    this->if_else();
+                    return NO_NODE;
                 }
 
                 case TokenType::THROW: {
@@ -309,369 +625,555 @@ class Parser {
 
                 case TokenType::L_BRACE: {
                     this->advance();
-                    return std::move(this->block());
+                    this->open_block();
+                    return NO_NODE;
                 }
 
                 default: {
-                    return std::move(this->variables());
+                    return this->variables();
+                }
+
+            }
+        }
+
+        // what block() and the statements with a body in them did recursively,
+        // on `nests`. `value` is a finished statement for the Nest on top, or
+        // NO_NODE when it's waiting on one that hasn't been started yet. a syntax
+        // error in a block's statement is recovered from at that block the way
+        // recover() does it, anywhere else it's passed on to the caller
+        NodeId nest(size_t base, NodeId value) {
+            size_t frames_mark = this->frames.size();
+
+            while (true) {
+                try {
+                    while (this->nests.size() > base) {
+                        value = value == NO_NODE ? this->open() : this->close(value);
+                    }
+
+                    return value;
+                } catch (const ParseError&) {
+                    while (this->nests.size() > base && this->nests.back().kind != Nest::BLOCK)
+                        this->nests.pop_back();
+
+                    if (this->nests.size() == base || this->diagnostics.full()) {
+                        this->nests.resize(base);
+                        throw;
+                    }
+
+                    Nest& block = this->nests.back();
+                    this->stack.resize(block.top);
+                    this->frames.resize(frames_mark);
+                    this->synchronize();
+
+                    // always get past at least one token, or the block would just fail on it again
+                    if (this->index == block.start && !this->at_end())
+                        this->index++;
+
+                    value = NO_NODE;
                 }
+            }
+        }
 
+        // starts the statement the Nest on top is waiting on
+        NodeId open(void) {
+            Nest& nest = this->nests.back();
+
+            if (nest.kind != Nest::BLOCK)
+                return this->statement();
+
+            if (this->match({TokenType::R_BRACE})) {
+                NodeId block = this->ast.add_block(nest.loc, this->collect(this->stack, nest.mark));
+                this->nests.pop_back();
+                return block;
+            }
+
+            // a declaration in here means the block was never closed. that's for
+            // whatever the block is in to recover from, not the block itself
+            if (this->at_end() || declarations.has(this->tokens.kind(this->index))) {
+                this->nests.pop_back();
+                this->error("Expected closing brace at the end of block", this->previous());
             }
+
+            nest.top = this->stack.size();
+            nest.start = this->index;
+            return this->statement();
         }
 
-        std::shared_ptr<Stmt::Stmt> _throw(void) {
-            std::shared_ptr<Expr::Expr> body = this->equality();
+        // hands a finished statement to the Nest on top. NO_NODE if it needs
+        // another one, otherwise the Nest is done and that's its node
+        NodeId close(NodeId value) {
+            Nest nest = this->nests.back();
+
+            switch (nest.kind) {
+
+                case Nest::BLOCK: {
+                    this->stack.push_back(value);
+                    return NO_NODE;
+                }
+
+                case Nest::IF: {
+                    if (this->match({TokenType::ELSE})) {
+                        this->nests.back().kind = Nest::ELSE;
+                        this->nests.back().second = value;
+                        return NO_NODE;
+                    }
+
+                    this->nests.pop_back();
+                    return this->ast.add_if(nest.loc, nest.first, value, NO_NODE);
+                }
+
+                case Nest::ELSE: {
+                    this->nests.pop_back();
+                    return this->ast.add_if(nest.loc, nest.first, nest.second, value);
+                }
+
+                case Nest::WHILE: {
+                    this->nests.pop_back();
+                    return this->ast.add_while(nest.loc, nest.first, value);
+                }
+
+                case Nest::C_FOR: {
+                    this->nests.pop_back();
+                    return this->ast.add_c_for(nest.loc, nest.first, nest.second, nest.third, value);
+                }
+
+                case Nest::FINN_FOR: {
+                    this->nests.pop_back();
+                    return this->ast.add_finn_for(nest.loc, nest.first, nest.types, nest.third, value);
+                }
+
+            }
+
+            return NO_NODE;
+        }
+
+        void open_block(void) {
+            Nest block{Nest::BLOCK, this->loc_of(this->index - 1)};
+            block.mark = this->stack.size();
+            this->nests.push_back(block);
+        }
+
+        NodeId _throw(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
+            NodeId body = this->binary();
             this->consume(TokenType::SEMICOLON, "Expected semicolon after throw statement");
-            return std::make_shared<Stmt::Throw>(Stmt::Throw(std::move(body)));
+            return this->ast.add_throw(keyword, body);
         }
 
-        std::shared_ptr<Stmt::Stmt> _return(void) {
-            std::shared_ptr<Expr::Expr> body = this->equality();
+        NodeId _return(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
+            NodeId body = this->binary();
 
             this->consume(TokenType::SEMICOLON, "Expected semicolon after return statement");
 
-            return std::make_shared<Stmt::Return>(Stmt::Return(std::move(body)));
+            return this->ast.add_return(keyword, body);
         }
 
-        std::shared_ptr<Stmt::Stmt> for_loop(void) {
+        // everything up to the body, which nest() parses
+        void for_loop(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
+
             bool is_finn_type_for_loop = false;
             bool is_c_type_for_loop = false;
 
-            std::shared_ptr<Expr::Expr> name = nullptr;
-            std::vector<std::shared_ptr<Expr::Expr>> types = {};
-            std::shared_ptr<Expr::Expr> iterator = nullptr;
+            NodeId name = NO_NODE;
+            uint32_t types = Ast::EMPTY_LIST;
+            NodeId iterator = NO_NODE;
 
-            std::shared_ptr<Stmt::Stmt> initial_variable = nullptr;
-            std::shared_ptr<Expr::Expr> conditional = nullptr;
-            std::shared_ptr<Expr::Expr> iterable = nullptr;
+            NodeId initial_variable = NO_NODE;
+            NodeId conditional = NO_NODE;
+            NodeId iterable = NO_NODE;
 
-            std::shared_ptr<Stmt::Stmt> body = nullptr;
+            this->consume(TokenType::L_PAREN, "Expected '(' after for");
 
-            if (this->match({TokenType::L_PAREN})) {
-                if (this->match({TokenType::LET})) {
-                    is_c_type_for_loop = true;
-                    initial_variable = this->mutable_var();
-                } else {
-                    is_finn_type_for_loop = true;
-                    name = this->literal();
-                    this->consume(TokenType::COLON, "Expected colon in name definition");
+            if (this->match({TokenType::LET})) {
+                is_c_type_for_loop = true;
+                initial_variable = this->mutable_var();
+            } else {
+                is_finn_type_for_loop = true;
+                name = this->literal();
+                this->consume(TokenType::COLON, "Expected colon in name definition");
 
-                    types.push_back(this->literal());
-                    while (this->match({TokenType::PIPE}))
-                        types.push_back(this->literal());
+                size_t mark = this->stack.size();
 
-                    this->consume(TokenType::R_PAREN, "Expected closing parenthesis in for loop");
-                }
+                this->stack.push_back(this->literal());
+                while (this->match({TokenType::PIPE}))
+                    this->stack.push_back(this->literal());
+
+                types = this->collect(this->stack, mark);
+
+                this->consume(TokenType::R_PAREN, "Expected closing parenthesis in for loop");
             }
 
             if (is_c_type_for_loop) {
-                conditional = this->equality();
+                conditional = this->binary();
                 this->consume(TokenType::SEMICOLON, "Expected semicolon after conditional");
 
-                iterable = this->suffix();
+                iterable = this->binary(Precedence::POSTFIX);
                 this->consume(TokenType::R_PAREN, "Expected closing parenthesis");
             }
 
             if (is_finn_type_for_loop) {
                 this->consume(TokenType::COLON, "Expected colon in for loop");
-                iterator = this->range();
+                iterator = this->binary(Precedence::RANGE);
             }
 
 
-            if (this->match({TokenType::L_BRACE}))
-                body = this->block();
-            else
-                body = this->control_flow();
-
             if (is_c_type_for_loop)
-                return std::make_shared<Stmt::CFor>(Stmt::CFor(std::move(initial_variable), std::move(conditional), std::move(iterable), std::move(body)));
+                this->nests.push_back(Nest{Nest::C_FOR, keyword, initial_variable, conditional, iterable});
             else
-                return std::make_shared<Stmt::FinnFor>(Stmt::FinnFor(std::move(name), types, std::move(iterator), std::move(body)));
+                this->nests.push_back(Nest{Nest::FINN_FOR, keyword, name, NO_NODE, iterator, types});
         }
 
-        std::shared_ptr<Stmt::Stmt> while_loop(void) {
-            std::shared_ptr<Expr::Expr> conditional = this->equality();
-            std::shared_ptr<Stmt::Stmt> body = this->control_flow();
-            return std::make_shared<Stmt::While>(Stmt::While(std::move(conditional), std::move(body)));
+        void while_loop(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
+            NodeId conditional = this->binary();
+            this->nests.push_back(Nest{Nest::WHILE, keyword, conditional});
         }
 
-        std::shared_ptr<Stmt::Stmt> if_else(void) {
+        // an else if is just an else with an if for its statement, so a chain of
+        // them is a run of Nests rather than recursion
+        void if_else(void) {
+            SourceLoc keyword = this->loc_of(this->index - 1);
             //this->consume(TokenType::L_PAREN, "Expected opening parenthesis for conditional");
-            std::shared_ptr<Expr::Expr> conditional = this->equality();
+            NodeId conditional = this->binary();
             //this->consume(TokenType::R_PAREN, "Expected closing parenthesis for conditional");
 
-            std::shared_ptr<Stmt::Stmt> then_branch = this->control_flow();
-            std::shared_ptr<Stmt::Stmt> else_branch = nullptr;
-
-            if (this->match({TokenType::ELSE}))
-                else_branch = this->control_flow();
-
-            return std::make_shared<Stmt::If>(Stmt::If(std::move(conditional), std::move(then_branch), std::move(else_branch)));
+            this->nests.push_back(Nest{Nest::IF, keyword, conditional});
         }
 
-        std::shared_ptr<Stmt::Stmt> block(void) {
-            std::vector<std::shared_ptr<Stmt::Stmt>> statements = {};
-
-            while (!this->match({TokenType::R_BRACE}))
-                statements.push_back(std::move(this->control_flow()));
-            
-            this->index--;
-            this->consume(TokenType::R_BRACE, "Expected closing brace at the end of block");
-            return std::make_shared<Stmt::Block>(Stmt::Block(statements));
-        }
-
-        std::shared_ptr<Stmt::Stmt> variables(void) {
-            switch (this->peek()->token_type) {
+        NodeId variables(void) {
+            switch (this->tokens.kind(this->index)) {
 
                 case TokenType::LET: {
                     this->advance();
-                    return std::move(this->mutable_var());
+                    return this->mutable_var();
                 }
 
                 case TokenType::CONST: {
                     this->advance();
-                    return std::move(this->constant());
+                    return this->constant();
                 }
 
                 default: {
-                    return std::move(this->expression());
+                    return this->expression();
                 }
 
             }
         }
 
-        std::shared_ptr<Stmt::Stmt> constant(void) {
-            std::shared_ptr<Token> name = this->advance();
-            std::vector<std::shared_ptr<Expr::Expr>> types = {};
-            std::shared_ptr<Expr::Expr> value;
+        NodeId constant(void) {
+            Token name = this->advance();
+            size_t mark = this->stack.size();
+            NodeId value;
 
             if (this->match({TokenType::COLON})) {
-                types.push_back(std::move(this->literal()));
+                this->stack.push_back(this->literal());
                 while (this->match({TokenType::PIPE})) {
-                    types.push_back(std::move(this->literal()));
+                    this->stack.push_back(this->literal());
                 }
             }
 
-            if (this->match({TokenType::IDENT})) {
-                std::cout << "Cannot have identifier before equals";
-                exit(1);
-            }
+            uint32_t types = this->collect(this->stack, mark);
+
+            if (this->match({TokenType::IDENT}))
+                this->error("Cannot have identifier before equals", this->previous());
 
             this->consume(TokenType::EQUAL, "Expected equals operator in constant definition");
-            value = std::move(this->equality());
+            value = this->binary();
             this->consume(TokenType::SEMICOLON, "Expected semicolon at the end of expression");
-            return std::make_shared<Stmt::Constant>(Stmt::Constant(std::move(name), types, std::move(value)));
+            return this->ast.add_constant(name.loc(), Interner::intern(name.lexeme), types, value);
         }
 
-        std::shared_ptr<Stmt::Stmt> mutable_var(void) {
-            std::shared_ptr<Token> name = this->advance();
-            std::vector<std::shared_ptr<Expr::Expr>> types = {};
-            std::shared_ptr<Expr::Expr> value;
+        NodeId mutable_var(void) {
+            Token name = this->advance();
+            size_t mark = this->stack.size();
+            NodeId value;
 
             bool is_static = false;
 
             if (this->match({TokenType::COLON})) {
-                types.push_back(std::move(this->scope()));
+                this->stack.push_back(this->scope());
 
                 while (this->match({TokenType::PIPE})) 
-                    types.push_back(std::move(this->scope()));
+                    this->stack.push_back(this->scope());
             }
 
-            if (this->match({TokenType::IDENT})) {
-                std::cout << "Cannot have identifier before equals";
-                exit(1);
-            }
+            uint32_t types = this->collect(this->stack, mark);
+
+            if (this->match({TokenType::IDENT}))
+                this->error("Cannot have identifier before equals", this->previous());
 
             if (this->match({TokenType::SEMICOLON})) {
-                value = std::make_shared<Expr::Nil>(Expr::Nil());
-                return std::make_shared<Stmt::Mutable>(Stmt::Mutable(std::move(name), types, std::move(value)));
+                value = this->ast.add_nil(SourceLoc{});
+                return this->ast.add_mutable(name.loc(), Interner::intern(name.lexeme), types, value);
             }
 
             this->consume(TokenType::EQUAL, "Expected equals operator in variable definition");
-            value = std::move(this->equality());
+            value = this->binary();
             this->consume(TokenType::SEMICOLON, "Expected semicolon at the end of expression");
-            return std::make_shared<Stmt::Mutable>(Stmt::Mutable(std::move(name), types, std::move(value)));
+            return this->ast.add_mutable(name.loc(), Interner::intern(name.lexeme), types, value);
         }
 
-        std::shared_ptr<Stmt::Stmt> expression(void) {
-            std::shared_ptr<Stmt::Stmt> expression = std::make_shared<Stmt::Expression>(Stmt::Expression(this->equality()));
+        NodeId expression(void) {
+            SourceLoc start = this->loc_of(this->index);
+            NodeId expression = this->ast.add_expression(start, this->binary());
             this->consume(TokenType::SEMICOLON, "Expected semicolon after expression");
-            return std::move(expression);
+            return expression;
         }
 
-        std::shared_ptr<Expr::Expr> equality(void) {
-            std::shared_ptr<Expr::Expr> expr = this->comparison();
-
-            while (this->match({TokenType::EQUAL_EQUAL, TokenType::NOT_EQUAL})) {
-                std::shared_ptr<Token> operand = this->previous();
-                std::shared_ptr<Expr::Expr> right = this->comparison();
-                expr = std::make_shared<Expr::Binary>(Expr::Binary(expr, operand, right));
-            }
-
-            return std::move(expr);
+        // binary(), unary(), scope() and call() all run on the same machine below.
+        // each one pushes the frames it starts out with and lets it go until they're
+        // all popped again, so nested groupings, calls and prefix chains grow
+        // `frames` rather than the native stack
+        NodeId binary(Precedence::Power power = Precedence::LOWEST) {
+            size_t base = this->frames.size();
+            this->frames.push_back(Frame{Frame::BINARY, power});
+            return this->run(base, Descend::UNARY);
         }
 
-        std::shared_ptr<Expr::Expr> comparison(void) {
-            std::shared_ptr<Expr::Expr> expr = this->term();
-
-            while (this->match({TokenType::GT, TokenType::GT_EQUALS, TokenType::LT, TokenType::LT_EQUALS})) {
-                std::shared_ptr<Token> operand = this->previous();
-                std::shared_ptr<Expr::Expr> right = this->term();
-                expr = std::make_shared<Expr::Binary>(Expr::Binary(expr, operand, right));
-            }
-
-            return std::move(expr);
+        NodeId unary(void) {
+            return this->run(this->frames.size(), Descend::UNARY);
         }
 
-        std::shared_ptr<Expr::Expr> term(void) {
-            std::shared_ptr<Expr::Expr> expr = this->factor();
-
-            while (this->match({TokenType::PLUS, TokenType::MINUS})) {
-                std::shared_ptr<Token> operand = this->previous();
-                std::shared_ptr<Expr::Expr> right = this->factor();
-                expr = std::make_shared<Expr::Binary>(Expr::Binary(expr, operand, right));
-            }
-
-            return std::move(expr);
+        // a unary without the reassignment, so the '=' after `x: int` starts the default value
+        NodeId annotation(void) {
+            return this->run(this->frames.size(), Descend::TYPE);
         }
 
-        std::shared_ptr<Expr::Expr> factor(void) {
-            std::shared_ptr<Expr::Expr> expr = this->range();
-
-            while (this->match({TokenType::MULT, TokenType::DIV})) {
-                std::shared_ptr<Token> operand = this->previous();
-                std::shared_ptr<Expr::Expr> right = this->range();
-                expr = std::make_shared<Expr::Binary>(Expr::Binary(expr, operand, right));
-            }
-
-            return std::move(expr);
+        NodeId scope(void) {
+            size_t base = this->frames.size();
+            this->frames.push_back(Frame{Frame::SCOPE});
+            return this->run(base, Descend::CALL);
         }
 
-        std::shared_ptr<Expr::Expr> range(void) {
-            std::shared_ptr<Expr::Expr> expr = this->suffix();
-
-            while (this->match({TokenType::VARIADIC})) {
-                std::shared_ptr<Token> operand = this->previous();
-                std::shared_ptr<Expr::Expr> right = this->suffix();
-                expr = std::make_shared<Expr::Binary>(Expr::Binary(expr, operand, right));
-            }
-
-            return std::move(expr);
+        NodeId call(void) {
+            return this->run(this->frames.size(), Descend::CALL);
         }
 
-        std::shared_ptr<Expr::Expr> suffix(void) {
-            std::shared_ptr<Expr::Expr> expr = this->prefix();
-
-            while (this->match({TokenType::PLUS_PLUS, TokenType::MINUS_MINUS, TokenType::QUESTION, TokenType::BANG})) {
-                std::shared_ptr<Token> operand = this->previous();
-                expr = std::make_shared<Expr::Suffix>(Expr::Suffix(expr, operand));
-            }
+        // what the recursive parser did, turned inside out. `descend` starts on a
+        // new operand and pushes a frame for everything that has to happen once
+        // it's parsed, then `value` gets handed to the frame on top until one of
+        // them needs another operand or the machine gets back down to `base`
+        NodeId run(size_t base, Descend from) {
+            NodeId value = this->descend(from);
+
+            while (this->frames.size() > base) {
+                Frame& frame = this->frames.back();
+
+                switch (frame.kind) {
+
+                    // every binary and postfix operator in one loop. a binary operator
+                    // only binds if it's at least as strong as the frame's power, and
+                    // its right side is parsed one level up so chains of the same
+                    // level group to the left
+                    case Frame::BINARY: {
+                        if (frame.node != NO_NODE)
+                            value = this->ast.add_binary(frame.loc, frame.node, static_cast<TokenType>(frame.op), value);
+
+                        while (Precedence::postfix.has(this->tokens.kind(this->index))) {
+                            this->index++;
+                            value = this->ast.add_suffix(this->loc_of(this->index - 1), value, this->previous().token_type);
+                        }
+
+                        Precedence::Power infix = Precedence::infix[this->tokens.kind(this->index)];
+                        if (infix == Precedence::NONE || infix < frame.op_power) {
+                            this->frames.pop_back();
+                            break;
+                        }
+
+                        frame.node = value;
+                        frame.op = this->tokens.kind(this->index);
+                        frame.loc = this->loc_of(this->index);
+                        this->index++;
+
+                        this->frames.push_back(Frame{Frame::BINARY, static_cast<Precedence::Power>(infix + 1)});
+                        value = this->descend(Descend::UNARY);
+                        break;
+                    }
 
-            return std::move(expr);
-        }
+                    case Frame::PREFIX: {
+                        value = this->ast.add_prefix(frame.loc, value, static_cast<TokenType>(frame.op));
+                        this->frames.pop_back();
+                        break;
+                    }
 
-        std::shared_ptr<Expr::Expr> prefix(void) {
-            while (this->match({TokenType::MULT, TokenType::AMPERSAND, TokenType::MINUS, TokenType::VARIADIC, TokenType::PLUS_PLUS, TokenType::MINUS_MINUS})) {
-                std::shared_ptr<Token> operand = this->previous();
-                std::shared_ptr<Expr::Expr> expr = this->prefix();
-                return std::move(std::make_shared<Expr::Prefix>(Expr::Prefix(expr, operand)));
-            } return std::move(this->reassign());
-        }
+                    case Frame::ASSIGN: {
+                        if (frame.node != NO_NODE) {
+                            value = this->ast.add_reassign(frame.loc, frame.node, value);
+                            this->frames.pop_back();
+                            break;
+                        }
+
+                        if (!this->match({TokenType::EQUAL})) {
+                            this->frames.pop_back();
+                            break;
+                        }
+
+                        frame.node = value;
+                        frame.loc = this->loc_of(this->index - 1);
+                        this->frames.push_back(Frame{Frame::BINARY, Precedence::LOWEST});
+                        value = this->descend(Descend::UNARY);
+                        break;
+                    }
 
-        std::shared_ptr<Expr::Expr> reassign(void) {
-            std::shared_ptr<Expr::Expr> expr = this->scope();
-            
-            if (this->match({TokenType::EQUAL})) {
-                expr = std::make_shared<Expr::Reassign>(Expr::Reassign(std::move(expr), this->equality()));
-            }
+                    case Frame::SCOPE: {
+                        if (frame.node != NO_NODE)
+                            value = this->ast.add_scope(frame.loc, frame.node, value);
 
-            return expr;
-        }
+                        if (!this->match({TokenType::DOT})) {
+                            this->frames.pop_back();
+                            break;
+                        }
 
-        std::shared_ptr<Expr::Expr> scope(void) {
-            std::shared_ptr<Expr::Expr> expr = this->call();
+                        frame.node = value;
+                        frame.loc = this->loc_of(this->index - 1);
+                        value = this->descend(Descend::CALL);
+                        break;
+                    }
 
-            while (this->match({TokenType::DOT}))
-                expr = std::make_shared<Expr::Scope>(Expr::Scope(std::move(expr), this->call()));
-            
-            return std::move(expr);
-        }
+                    case Frame::CALL: {
+                        if (frame.node == NO_NODE) {
+                            if (!this->match({TokenType::L_PAREN})) {
+                                this->frames.pop_back();
+                                break;
+                            }
+
+                            frame.node = value;
+                            frame.loc = this->loc_of(this->index - 1);
+                            frame.mark = this->stack.size();
+
+                            if (!this->match({TokenType::R_PAREN})) {
+                                this->frames.push_back(Frame{Frame::BINARY, Precedence::LOWEST});
+                                value = this->descend(Descend::UNARY);
+                                break;
+                            }
+                        }
+
+                        else {
+                            this->stack.push_back(value);
+
+                            if (this->match({TokenType::COMMA})) {
+                                this->frames.push_back(Frame{Frame::BINARY, Precedence::LOWEST});
+                                value = this->descend(Descend::UNARY);
+                                break;
+                            }
+
+                            this->consume(TokenType::R_PAREN, "Expected closing parenthesis");
+                        }
+
+                        value = this->ast.add_call(frame.loc, frame.node, this->collect(this->stack, frame.mark));
+                        this->frames.pop_back();
+                        break;
+                    }
 
-        std::shared_ptr<Expr::Expr> call(void) {
-            std::shared_ptr<Expr::Expr> expr = this->literal();
+                    case Frame::GROUPING: {
+                        value = this->ast.add_grouping(frame.loc, value);
+                        this->consume(TokenType::R_PAREN, "Expected closing parenthesis");
+                        this->frames.pop_back();
+                        break;
+                    }
 
-            if (this->match({TokenType::L_PAREN})) {
-                std::vector<std::shared_ptr<Expr::Expr>> args = {};
+                }
+            }
 
-                if (!this->match({TokenType::R_PAREN})) {
-                    args.push_back(std::move(this->equality()));
+            return value;
+        }
 
-                    while (this->match({TokenType::COMMA})) {
-                        args.push_back(std::move(this->equality()));
+        // pushes the frames for a unary (prefix operators, the scope chain and a
+        // possible reassignment), a type (the same minus the reassignment) or just
+        // a call, down to the first literal. a grouping starts over on a whole new
+        // binary inside it
+        NodeId descend(Descend from) {
+            while (true) {
+                if (from != Descend::CALL) {
+                    while (Precedence::prefix.has(this->tokens.kind(this->index))) {
+                        this->frames.push_back(Frame{Frame::PREFIX, Precedence::NONE, static_cast<uint8_t>(this->tokens.kind(this->index)), this->loc_of(this->index)});
+                        this->index++;
                     }
 
-                    this->consume(TokenType::R_PAREN, "Expected closing parenthesis");
+                    if (from == Descend::UNARY)
+                        this->frames.push_back(Frame{Frame::ASSIGN});
+                    this->frames.push_back(Frame{Frame::SCOPE});
                 }
 
-                expr = std::make_shared<Expr::Call>(Expr::Call(std::move(expr), args));
-            }
+                this->frames.push_back(Frame{Frame::CALL});
+
+                if (!this->match({TokenType::L_PAREN}))
+                    return this->literal();
 
-            return std::move(expr);
+                this->frames.push_back(Frame{Frame::GROUPING, Precedence::NONE, 0, this->loc_of(this->index - 1)});
+                this->frames.push_back(Frame{Frame::BINARY, Precedence::LOWEST});
+                from = Descend::UNARY;
+            }
         }
 
-        std::shared_ptr<Expr::Expr> literal(void) {
-            switch (this->peek()->token_type) {
+        NodeId literal(void) {
+            SourceLoc loc = this->loc_of(this->index);
+
+            switch (this->tokens.kind(this->index)) {
 
                 case TokenType::IDENT: {
                     this->advance();
-                    return std::move(std::make_shared<Expr::Variable>(Expr::Variable(this->previous()->lexeme)));
+                    return this->ast.add_variable(loc, Interner::intern(this->previous().lexeme));
                 }
 
                 case TokenType::STRING: {
                     this->advance();
-                    return std::move(std::make_shared<Expr::StringLit>(Expr::StringLit(this->previous()->lexeme)));
+                    return this->ast.add_string(loc, Interner::intern(this->previous().lexeme));
                 }
 
                 case TokenType::NIL: {
                     this->advance();
-                    return std::move(std::make_shared<Expr::Nil>(Expr::Nil()));
+                    return this->ast.add_nil(loc);
                 }
 
                 case TokenType::INT: {
                     this->advance();
-                    return std::move(std::make_shared<Expr::IntLit>(Expr::IntLit(std::atoi(this->previous()->lexeme.c_str()))));
+                    Literal::Integer integer = Literal::parse_integer(this->previous().lexeme);
+
+                    // the literal is still fine syntax wise, so there's nothing to recover from
+                    if (integer.overflow)
+                        this->diagnostics.report("Integer literal doesn't fit in 128 bits", this->previous());
+                    else if (integer.empty)
+                        this->diagnostics.report("Expected digits after " + std::string(this->previous().lexeme), this->previous());
+
+                    return this->ast.add_integer(loc, integer.value);
                 }
 
                 case TokenType::FLOAT: {
                     this->advance();
-                    return std::make_shared<Expr::FloatLit>(Expr::FloatLit(std::atof(this->previous()->lexeme.c_str())));
+                    Literal::Float floating = Literal::parse_float(this->previous().lexeme);
+
+                    if (floating.overflow)
+                        this->diagnostics.report("Float literal doesn't fit in a double", this->previous());
+
+                    return this->ast.add_float(loc, floating.value);
                 }
 
                 case TokenType::TRUE: {
                     this->advance();
-                    return std::move(std::make_shared<Expr::BoolLit>(Expr::BoolLit(true)));
+                    return this->ast.add_bool(loc, true);
                 }
 
                 case TokenType::FALSE: {
                     this->advance();
-                    return std::move(std::make_shared<Expr::BoolLit>(Expr::BoolLit(false)));
+                    return this->ast.add_bool(loc, false);
                 }
 
                 case TokenType::L_PAREN: {
                     this->advance();
-                    Expr::Grouping expression = Expr::Grouping(this->equality());
+                    NodeId expression = this->ast.add_grouping(loc, this->binary());
                     this->consume(TokenType::R_PAREN, "Expected closing parenthesis");
-                    return std::move(std::make_shared<Expr::Grouping>(expression));
+                    return expression;
                 }
 
                 default: {
 
                     if (this->match({TYPES})) {
-                        return std::make_shared<Expr::Type>(Expr::Type(this->previous()));
+                        return this->ast.add_type(loc, Interner::intern(this->previous().lexeme), this->previous().token_type);
                     } else {
-                        std::cout << this->peek()->lexeme << "\n";
-                        Error("you messed up", lines, this->peek()).print();
-                        exit(1);
+                        this->error("Expected an expression", this->peek());
                     }
                 }
 
@@ -0,0 +1,94 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// fixed size pool of worker threads pulling from one shared queue
+class ThreadPool {
+    std::vector<std::thread>          workers;
+    std::deque<std::function<void()>> tasks;
+
+    std::mutex              mutex;
+    std::condition_variable available;
+    std::condition_variable finished;
+
+    size_t running  = 0;
+    bool   stopping = false;
+
+    public:
+        ThreadPool(size_t size) {
+            for (size_t i = 0; i < size; i++)
+                this->workers.emplace_back([this]() { this->work(); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->stopping = true;
+            }
+            this->available.notify_all();
+
+            for (std::thread& worker : this->workers)
+                worker.join();
+        }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->tasks.push_back(std::move(task));
+            }
+            this->available.notify_one();
+        }
+
+        // blocks until every submitted task has finished
+        void wait(void) {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->finished.wait(lock, [this]() { return this->tasks.empty() && this->running == 0; });
+        }
+
+        size_t size(void) const { return this->workers.size(); }
+
+        static size_t default_size(void) {
+            size_t cores = std::thread::hardware_concurrency();
+            return cores == 0 ? 1 : cores;
+        }
+
+    private:
+        void work(void) {
+            while (true) {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(this->mutex);
+                    this->available.wait(lock, [this]() { return this->stopping || !this->tasks.empty(); });
+
+                    if (this->stopping && this->tasks.empty())
+                        return;
+
+                    task = std::move(this->tasks.front());
+                    this->tasks.pop_front();
+                    this->running++;
+                }
+
+                task();
+
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->running--;
+                }
+                this->finished.notify_all();
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,311 @@
+#ifndef SCAN_HPP
+#define SCAN_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "chars.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <immintrin.h>
+#define FINN_SCAN_X86
+#endif
+
+// bulk scanners for the lexer. every function takes [position, end) and returns
+// the first byte that ends the run, they never read past end. the ones that can
+// skip over newlines add how many they skipped to `lines` so the line counter
+// stays right
+namespace Scan {
+
+inline bool is_whitespace(char character) {
+    return Chars::is(character, Chars::SPACE);
+}
+
+inline bool is_identifier(char character) {
+    return Chars::is(character, Chars::IDENT);
+}
+
+inline bool is_digit(char character) {
+    return Chars::is(character, Chars::DIGIT);
+}
+
+namespace Scalar {
+
+inline const char* identifier(const char* position, const char* end) {
+    while (position < end && is_identifier(*position))
+        position++;
+    return position;
+}
+
+inline const char* digits(const char* position, const char* end) {
+    while (position < end && is_digit(*position))
+        position++;
+    return position;
+}
+
+inline const char* whitespace(const char* position, const char* end, size_t& lines) {
+    while (position < end && is_whitespace(*position)) {
+        if (*position == '\n')
+            lines++;
+        position++;
+    }
+    return position;
+}
+
+inline const char* find(const char* position, const char* end, char target, size_t& lines) {
+    while (position < end && *position != target) {
+        if (*position == '\n')
+            lines++;
+        position++;
+    }
+    return position;
+}
+
+inline const char* special(const char* position, const char* end) {
+    while (position < end && *position != '"' && *position != '/' && *position != '\n')
+        position++;
+    return position;
+}
+
+}
+
+#ifdef FINN_SCAN_X86
+
+// sse2 is part of x86-64 so these are used directly, the short identifier and
+// digit runs don't win anything from going through the dispatch table
+namespace SSE2 {
+
+inline uint32_t identifier_mask(__m128i chunk) {
+    __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    __m128i under = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_'));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), under));
+}
+
+inline uint32_t digit_mask(__m128i chunk) {
+    return _mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1))));
+}
+
+inline uint32_t whitespace_mask(__m128i chunk) {
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')));
+    __m128i line  = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+    return _mm_movemask_epi8(_mm_or_si128(space, line));
+}
+
+inline uint32_t newline_mask(__m128i chunk) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+}
+
+inline const char* identifier(const char* position, const char* end) {
+    while (end - position >= 16) {
+        uint32_t stop = ~identifier_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(position))) & 0xFFFF;
+        if (stop != 0)
+            return position + __builtin_ctz(stop);
+        position += 16;
+    }
+    return Scalar::identifier(position, end);
+}
+
+inline const char* digits(const char* position, const char* end) {
+    while (end - position >= 16) {
+        uint32_t stop = ~digit_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(position))) & 0xFFFF;
+        if (stop != 0)
+            return position + __builtin_ctz(stop);
+        position += 16;
+    }
+    return Scalar::digits(position, end);
+}
+
+inline const char* whitespace(const char* position, const char* end, size_t& lines) {
+    while (end - position >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+        uint32_t stop = ~whitespace_mask(chunk) & 0xFFFF;
+        uint32_t newlines = newline_mask(chunk);
+
+        if (stop != 0) {
+            uint32_t offset = __builtin_ctz(stop);
+            lines += __builtin_popcount(newlines & ((1u << offset) - 1));
+            return position + offset;
+        }
+
+        lines += __builtin_popcount(newlines);
+        position += 16;
+    }
+    return Scalar::whitespace(position, end, lines);
+}
+
+inline const char* find(const char* position, const char* end, char target, size_t& lines) {
+    __m128i wanted = _mm_set1_epi8(target);
+
+    while (end - position >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+        uint32_t stop = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, wanted));
+        uint32_t newlines = newline_mask(chunk);
+
+        if (stop != 0) {
+            uint32_t offset = __builtin_ctz(stop);
+            lines += __builtin_popcount(newlines & ((1u << offset) - 1));
+            return position + offset;
+        }
+
+        lines += __builtin_popcount(newlines);
+        position += 16;
+    }
+    return Scalar::find(position, end, target, lines);
+}
+
+inline const char* special(const char* position, const char* end) {
+    while (end - position >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+        __m128i quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+        __m128i slash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/'));
+        uint32_t stop = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(quote, slash), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+
+        if (stop != 0)
+            return position + __builtin_ctz(stop);
+        position += 16;
+    }
+    return Scalar::special(position, end);
+}
+
+}
+
+// only compiled for avx2, never called unless the cpu says it has it
+namespace AVX2 {
+
+__attribute__((target("avx2")))
+inline const char* whitespace(const char* position, const char* end, size_t& lines) {
+    while (end - position >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(position));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')));
+        __m256i line  = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+        __m256i blank = _mm256_or_si256(_mm256_or_si256(space, line), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')));
+
+        uint32_t stop = ~static_cast<uint32_t>(_mm256_movemask_epi8(blank));
+        uint32_t newlines = _mm256_movemask_epi8(line);
+
+        if (stop != 0) {
+            uint32_t offset = __builtin_ctz(stop);
+            lines += __builtin_popcount(newlines & ((1u << offset) - 1));
+            return position + offset;
+        }
+
+        lines += __builtin_popcount(newlines);
+        position += 32;
+    }
+    return SSE2::whitespace(position, end, lines);
+}
+
+__attribute__((target("avx2")))
+inline const char* find(const char* position, const char* end, char target, size_t& lines) {
+    __m256i wanted = _mm256_set1_epi8(target);
+    __m256i newline = _mm256_set1_epi8('\n');
+
+    while (end - position >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(position));
+        uint32_t stop = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, wanted));
+        uint32_t newlines = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline));
+
+        if (stop != 0) {
+            uint32_t offset = __builtin_ctz(stop);
+            lines += __builtin_popcount(newlines & ((1u << offset) - 1));
+            return position + offset;
+        }
+
+        lines += __builtin_popcount(newlines);
+        position += 32;
+    }
+    return SSE2::find(position, end, target, lines);
+}
+
+__attribute__((target("avx2")))
+inline const char* special(const char* position, const char* end) {
+    while (end - position >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(position));
+        __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+        __m256i slash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('/'));
+        uint32_t stop = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(quote, slash), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))));
+
+        if (stop != 0)
+            return position + __builtin_ctz(stop);
+        position += 32;
+    }
+    return SSE2::special(position, end);
+}
+
+}
+
+#endif
+
+// the long scans (whitespace runs, comment and string bodies) go through this
+// table, which picks the widest version the cpu supports the first time it's used
+struct Dispatch {
+    const char* (*whitespace)(const char*, const char*, size_t&);
+    const char* (*find)(const char*, const char*, char, size_t&);
+    const char* (*special)(const char*, const char*);
+};
+
+inline Dispatch select(void) {
+#ifdef FINN_SCAN_X86
+    if (__builtin_cpu_supports("avx2"))
+        return Dispatch{AVX2::whitespace, AVX2::find, AVX2::special};
+    return Dispatch{SSE2::whitespace, SSE2::find, SSE2::special};
+#else
+    return Dispatch{Scalar::whitespace, Scalar::find, Scalar::special};
+#endif
+}
+
+inline const Dispatch& dispatch(void) {
+    static const Dispatch table = select();
+    return table;
+}
+
+inline const char* identifier(const char* position, const char* end) {
+#ifdef FINN_SCAN_X86
+    return SSE2::identifier(position, end);
+#else
+    return Scalar::identifier(position, end);
+#endif
+}
+
+inline const char* digits(const char* position, const char* end) {
+#ifdef FINN_SCAN_X86
+    return SSE2::digits(position, end);
+#else
+    return Scalar::digits(position, end);
+#endif
+}
+
+inline const char* whitespace(const char* position, const char* end, size_t& lines) {
+    return dispatch().whitespace(position, end, lines);
+}
+
+inline const char* find(const char* position, const char* end, char target, size_t& lines) {
+    return dispatch().find(position, end, target, lines);
+}
+
+// next byte that can change what the lexer is inside of: a quote, a slash or a newline
+inline const char* special(const char* position, const char* end) {
+    return dispatch().special(position, end);
+}
+
+// returns the byte after the closing "*/", or end if the comment never closes
+inline const char* block_comment_end(const char* position, const char* end, size_t& lines) {
+    while (position < end) {
+        position = find(position, end, '*', lines);
+        if (position >= end)
+            return end;
+
+        position++;
+        if (position < end && *position == '/')
+            return position + 1;
+    }
+    return end;
+}
+
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef SCOPE_HPP
+#define SCOPE_HPP
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "intern.hpp"
+#include "ast.hpp"
+
+// every name that's visible right now, in one open addressing table keyed by
+// SymbolId. a declaration overwrites the name's slot and logs what was there
+// before, so leaving a scope is just rolling the log back to where it was when
+// the scope was entered. nothing is ever rebuilt or copied, and a slot stays
+// behind (unbound) once its name goes out of scope so it can be reused
+class Scopes {
+    static constexpr SymbolId EMPTY = UINT32_MAX;
+
+    struct Slot {
+        SymbolId name  = EMPTY;
+        NodeId   decl  = NO_NODE;
+        uint32_t depth = 0;
+    };
+
+    struct Undo {
+        SymbolId name;
+        NodeId   decl;
+        uint32_t depth;
+    };
+
+    std::vector<Slot>   slots = std::vector<Slot>(1024);
+    std::vector<Undo>   log;
+    std::vector<size_t> marks;
+
+    size_t used = 0;
+
+    static size_t hash(SymbolId name) {
+        return (static_cast<uint64_t>(name) * 0x9E3779B97F4A7C15ull) >> 32;
+    }
+
+    // the slot holding `name`, or the empty one it would go in
+    size_t find(SymbolId name) const {
+        size_t mask = this->slots.size() - 1;
+        size_t slot = hash(name) & mask;
+
+        while (this->slots[slot].name != EMPTY && this->slots[slot].name != name)
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+
+    void grow(void) {
+        std::vector<Slot> old = std::move(this->slots);
+        this->slots = std::vector<Slot>(old.size() * 2);
+
+        for (const Slot& slot : old)
+            if (slot.name != EMPTY)
+                this->slots[this->find(slot.name)] = slot;
+    }
+
+    public:
+        uint32_t depth(void) const { return this->marks.size(); }
+
+        void push(void) {
+            this->marks.push_back(this->log.size());
+        }
+
+        void pop(void) {
+            size_t mark = this->marks.back();
+            this->marks.pop_back();
+
+            while (this->log.size() > mark) {
+                const Undo& undo = this->log.back();
+                Slot& slot = this->slots[this->find(undo.name)];
+                slot.decl = undo.decl;
+                slot.depth = undo.depth;
+                this->log.pop_back();
+            }
+        }
+
+        // binds `name` in the innermost scope. if it's already bound there the
+        // old binding is kept and returned, NO_NODE otherwise
+        NodeId declare(SymbolId name, NodeId decl) {
+            size_t slot = this->find(name);
+
+            if (this->slots[slot].name == EMPTY) {
+                // keep the table at most half full
+                if ((this->used + 1) * 2 > this->slots.size()) {
+                    this->grow();
+                    slot = this->find(name);
+                }
+
+                this->slots[slot].name = name;
+                this->used++;
+            }
+
+            Slot& entry = this->slots[slot];
+
+            if (entry.decl != NO_NODE && entry.depth == this->depth())
+                return entry.decl;
+
+            this->log.push_back(Undo{name, entry.decl, entry.depth});
+            entry.decl = decl;
+            entry.depth = this->depth();
+            return NO_NODE;
+        }
+
+        // the innermost declaration of `name`, NO_NODE if there isn't one
+        NodeId lookup(SymbolId name) const {
+            return this->slots[this->find(name)].decl;
+        }
+};
+
+// the members of structs and enums, keyed by the declaring node and the
+// member's name together so every type shares one flat table
+class Members {
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+
+    struct Slot {
+        uint64_t key    = EMPTY;
+        NodeId   member = NO_NODE;
+    };
+
+    std::vector<Slot> slots = std::vector<Slot>(1024);
+    size_t            used  = 0;
+
+    static uint64_t key(NodeId owner, SymbolId name) {
+        return (static_cast<uint64_t>(owner) << 32) | name;
+    }
+
+    size_t find(uint64_t key) const {
+        size_t mask = this->slots.size() - 1;
+        size_t slot = ((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+        while (this->slots[slot].key != EMPTY && this->slots[slot].key != key)
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+
+    void grow(void) {
+        std::vector<Slot> old = std::move(this->slots);
+        this->slots = std::vector<Slot>(old.size() * 2);
+
+        for (const Slot& slot : old)
+            if (slot.key != EMPTY)
+                this->slots[this->find(slot.key)] = slot;
+    }
+
+    public:
+        // returns the member that already had the name, NO_NODE if there wasn't one
+        NodeId add(NodeId owner, SymbolId name, NodeId member) {
+            uint64_t wanted = key(owner, name);
+            size_t slot = this->find(wanted);
+
+            if (this->slots[slot].key != EMPTY)
+                return this->slots[slot].member;
+
+            if ((this->used + 1) * 2 > this->slots.size()) {
+                this->grow();
+                slot = this->find(wanted);
+            }
+
+            this->slots[slot] = Slot{wanted, member};
+            this->used++;
+            return NO_NODE;
+        }
+
+        NodeId get(NodeId owner, SymbolId name) const {
+            const Slot& slot = this->slots[this->find(key(owner, name))];
+            return slot.key == EMPTY ? NO_NODE : slot.member;
+        }
+};
+
+#endif
@@ -1,28 +1,568 @@
 #ifndef SEMA_HPP
 #define SEMA_HPP
 
-#include <memory>
+#pragma once
+
 #include <vector>
-#include <iostream>
+#include <string>
+#include <atomic>
+#include <algorithm>
 
-#include "expr.hpp"
+#include "ast.hpp"
+#include "visitor.hpp"
+#include "scope.hpp"
+#include "types.hpp"
+#include "errors.hpp"
+#include "pool.hpp"
 
+// name resolution. every VARIABLE that's a use of a name is pointed at the node
+// that declared it, in `resolved`. top level functions, structs, enums,
+// interfaces and imports are declared before anything is resolved so they can
+// be used before they're written, everything else has to come first. once a
+// declaration's names are resolved its annotation is turned into a TypeId in
+// `declared`.
+//
+// it runs in two passes. the first goes over the whole file on one thread and
+// leaves out the bodies of top level functions, so everything they could refer
+// to is known by the end of it. the second checks those bodies on `jobs`
+// threads. each thread has a Walker with its own scopes, and each body its own
+// Diagnostics, merged in source order afterwards so the output doesn't depend
+// on which thread got which body
 class SemaAnalyser {
-    const std::vector<std::shared_ptr<Stmt::Stmt>> statements;
+    const Ast&                 ast;
+    const std::vector<NodeId>& statements;
+    Diagnostics&               diagnostics;
+    size_t                     jobs;
 
-    public:
-        SemaAnalyser(const std::vector<std::shared_ptr<Stmt::Stmt>> statements)
-          : statements(statements) {}
+    Members   members;
+    TypeTable types;
+
+    // what a node is to whoever it's under, set on the way into the parent
+    enum class Role : uint8_t {
+        USE,      // an ordinary expression, names in it get resolved
+        NAME,     // the name a declaration gives, nothing to resolve
+        MEMBER,   // a member of the struct in `owner`
+        ACCESS,   // the right side of the SCOPE in `owner`
+        DEFERRED, // a top level function's body, left for the second pass
+    };
+
+    struct Context {
+        Role   role  = Role::USE;
+        NodeId owner = NO_NODE;
+    };
+
+    // indexed by node, a body only ever writes to its own nodes so the threads
+    // never touch the same entry
+    std::vector<Context> context;
+    std::vector<NodeId>  resolved;
+    std::vector<TypeId>  declared;
+
+    // what each function says it can throw, its return type is in `declared`
+    std::vector<TypeId> thrown;
+
+    // every top level declaration in the order the first pass made it, so a
+    // Walker can rebuild exactly what was visible where a function was
+    struct Binding {
+        SymbolId name;
+        NodeId   decl;
+    };
+
+    std::vector<Binding> module;
+
+    struct Body {
+        NodeId   func;
+        uint32_t visible; // how much of `module` the body can see
+    };
+
+    std::vector<Body> bodies;
+
+    size_t uses = 0;
+
+    // the module depth, one scope for the builtins and one for the file
+    static constexpr uint32_t MODULE = 2;
+
+    class Walker : public Visitor<Walker, bool> {
+        SemaAnalyser& sema;
+        const Ast&    ast;
+        Diagnostics*  diagnostics;
+
+        Scopes              scopes;
+        std::vector<TypeId> scratch;
+
+        bool   first_pass;
+        size_t applied = 0;
+
+        void set(NodeId id, Role role, NodeId owner = NO_NODE) {
+            if (id != NO_NODE)
+                this->sema.context[id] = Context{role, owner};
+        }
+
+        void redeclared(NodeId id, SymbolId name) {
+            std::string_view text = Interner::text(name);
+            this->diagnostics->report("'" + std::string(text) + "' is already declared in this scope", this->ast, id, text.length());
+        }
+
+        void declare(NodeId id, SymbolId name) {
+            if (this->scopes.declare(name, id) != NO_NODE)
+                this->redeclared(id, name);
+            else if (this->first_pass && this->scopes.depth() == MODULE)
+                this->sema.module.push_back(Binding{name, id});
+        }
+
+        // a single annotation as a type. `*T` is a pointer, a name has to resolve to
+        // a struct, enum or interface. names that didn't resolve were reported
+        // already and come out as the error type
+        TypeId annotation(NodeId id) {
+            TypeTable& types = this->sema.types;
+            size_t pointers = 0;
+
+            while (true) {
+                const Node& node = this->ast.get(id);
+
+                if (node.kind == NodeKind::PREFIX && node.token_type() == TokenType::MULT)
+                    pointers++;
+                else if (node.kind != NodeKind::GROUPING)
+                    break;
+
+                id = node.first;
+            }
+
+            const Node& node = this->ast.get(id);
+            TypeId type = types.error();
+
+            switch (node.kind) {
+
+                case NodeKind::TYPE: {
+                    type = types.primitive(node.token_type());
+                    break;
+                }
+
+                case NodeKind::NIL: {
+                    type = types.nil();
+                    break;
+                }
+
+                case NodeKind::VARIABLE: {
+                    NodeId decl = this->sema.resolved[id];
+
+                    if (decl == NO_NODE)
+                        break;
+
+                    NodeKind kind = decl == BUILTIN ? NodeKind::FUNC : this->ast.get(decl).kind;
+
+                    if (kind == NodeKind::STRUCT || kind == NodeKind::ENUM || kind == NodeKind::INTERFACE)
+                        type = this->sema.declared[decl];
+                    else
+                        this->not_a_type(id);
+                    break;
+                }
 
-        void begin_analysis(void) const {
-            for (auto& statement : this->statements)
-                this->analyse_statement(&statement);
+                // types from other modules aren't known until imports are loaded
+                case NodeKind::SCOPE: {
+                    break;
+                }
+
+                default: {
+                    this->not_a_type(id);
+                    break;
+                }
+
+            }
+
+            for (size_t i = 0; i < pointers; i++)
+                type = type == types.error() ? type : types.pointer(type);
+
+            return type;
         }
 
-    private:
-        void analyse_statement(const std::shared_ptr<Stmt::Stmt>* statement) const {
-            if (statement->id == "")
+        // a list of annotations is one union, NO_TYPE when there isn't any
+        TypeId annotations(uint32_t list) {
+            Span<const NodeId> items = this->ast.list(list);
+
+            if (items.size() == 1)
+                return this->annotation(items[0]);
+
+            this->scratch.clear();
+            for (NodeId item : items)
+                this->scratch.push_back(this->annotation(item));
+            return this->sema.types.union_of(this->scratch.data(), this->scratch.size());
+        }
+
+        void not_a_type(NodeId id) {
+            this->diagnostics->report("Expected a type", this->ast, id);
         }
+
+        // literals are the only values with a type that's known without a type checker
+        TypeId literal_type(NodeId id) {
+            switch (this->ast.get(id).kind) {
+                case NodeKind::NIL:        return this->sema.types.nil();
+                case NodeKind::STRING_LIT: return this->sema.types.primitive(TokenType::STR);
+                case NodeKind::BOOL_LIT:   return this->sema.types.primitive(TokenType::BOOL_TYPE);
+                default:                   return NO_TYPE;
+            }
+        }
+
+        public:
+            size_t uses = 0;
+
+            Walker(SemaAnalyser& sema, bool first_pass)
+              : sema(sema), ast(sema.ast), diagnostics(&sema.diagnostics), first_pass(first_pass) {
+                // until there's a standard library to import them from
+                this->scopes.push();
+                for (const char* name : {"print", "println"})
+                    this->scopes.declare(Interner::intern(name), BUILTIN);
+
+                this->scopes.push();
+            }
+
+            void walk(NodeId root) {
+                this->ast.walk(root,
+                    [&](NodeId id) { return this->visit(this->ast, id); },
+                    [&](NodeId id, uint32_t) { this->leave(id); });
+            }
+
+            // declarations at the top level can be used from anywhere in the file
+            void hoist(NodeId id) {
+                const Node& node = this->ast.get(id);
+
+                switch (node.kind) {
+
+                    case NodeKind::FUNC: {
+                        const Node& name = this->ast.get(node.first);
+                        // methods (func Point.area) belong to their type, not the module
+                        if (name.kind == NodeKind::VARIABLE)
+                            this->declare(node.first, name.text);
+                        break;
+                    }
+
+                    case NodeKind::STRUCT:
+                    case NodeKind::ENUM:
+                    case NodeKind::INTERFACE: {
+                        this->declare(id, node.text);
+                        this->sema.declared[id] = this->sema.types.named(id, node.text);
+                        break;
+                    }
+
+                    // `import std.io` makes `std` visible
+                    case NodeKind::IMPORT: {
+                        NodeId root = node.first;
+                        while (this->ast.get(root).kind == NodeKind::SCOPE)
+                            root = this->ast.get(root).first;
+
+                        if (this->ast.get(root).kind == NodeKind::VARIABLE)
+                            this->declare(id, this->ast.get(root).text);
+                        break;
+                    }
+
+                    default: {
+                        break;
+                    }
+
+                }
+            }
+
+            // a deferred body, with what was visible at its function and its args
+            // in scope. bodies have to come in source order, the module scope is
+            // only ever added to
+            void check(const Body& body, Diagnostics& found) {
+                for (; this->applied < body.visible; this->applied++)
+                    this->scopes.declare(this->sema.module[this->applied].name, this->sema.module[this->applied].decl);
+
+                const uint32_t* parts = this->ast.extra_data(this->ast.get(body.func).second);
+
+                this->diagnostics = &found;
+                this->scopes.push();
+
+                // they were checked in the first pass
+                for (NodeId arg : this->ast.list(parts[0]))
+                    this->scopes.declare(this->ast.get(arg).text, arg);
+
+                this->set(parts[3], Role::USE);
+                this->walk(parts[3]);
+
+                this->scopes.pop();
+                this->diagnostics = &this->sema.diagnostics;
+            }
+
+            // nodes without a visit_ method of their own are just walked into. the
+            // result of any visit_ method says whether to go into the node's children
+            bool visit_node(NodeId, const Node&) {
+                return true;
+            }
+
+            bool visit_block(NodeId id, const Node&) {
+                if (this->sema.context[id].role == Role::DEFERRED)
+                    return false;
+
+                this->scopes.push();
+                return true;
+            }
+
+            bool visit_c_for(NodeId, const Node&) {
+                this->scopes.push();
+                return true;
+            }
+
+            bool visit_finn_for(NodeId, const Node& node) {
+                const uint32_t* parts = this->ast.extra_data(node.first);
+
+                this->scopes.push();
+                this->set(parts[0], Role::NAME);
+
+                if (parts[0] != NO_NODE && this->ast.get(parts[0]).kind == NodeKind::VARIABLE)
+                    this->declare(parts[0], this->ast.get(parts[0]).text);
+                return true;
+            }
+
+            bool visit_func(NodeId id, const Node& node) {
+                this->set(node.first, Role::NAME);
+
+                // a function inside an interface is one of its members, and is
+                // checked right here with the rest of the interface
+                if (this->scopes.depth() > MODULE && this->ast.get(node.first).kind == NodeKind::VARIABLE)
+                    this->declare(node.first, this->ast.get(node.first).text);
+
+                NodeId body = this->ast.extra_data(node.second)[3];
+                if (this->first_pass && this->scopes.depth() == MODULE && body != NO_NODE) {
+                    this->set(body, Role::DEFERRED);
+                    this->sema.bodies.push_back(Body{id, static_cast<uint32_t>(this->sema.module.size())});
+                }
+
+                this->scopes.push();
+                return true;
+            }
+
+            bool visit_interface(NodeId, const Node&) {
+                this->scopes.push();
+                return true;
+            }
+
+            bool visit_struct(NodeId id, const Node& node) {
+                for (NodeId member : this->ast.list(node.first))
+                    this->set(member, Role::MEMBER, id);
+                return true;
+            }
+
+            // every variant shares the enum's list of types, which says what the
+            // variants are stored as. it's resolved and made a type once, here, and
+            // the variants are taken care of without walking into it again
+            bool visit_enum(NodeId id, const Node& node) {
+                for (NodeId type : this->ast.list(node.first))
+                    this->walk(type);
+
+                TypeId stored = this->annotations(node.first);
+
+                for (NodeId variant : this->ast.list(node.second)) {
+                    const Node& member = this->ast.get(variant);
+
+                    if (member.second != NO_NODE)
+                        this->walk(member.second);
+
+                    this->sema.declared[variant] = stored;
+                    if (this->sema.members.add(id, member.text, variant) != NO_NODE)
+                        this->redeclared(variant, member.text);
+                }
+
+                return false;
+            }
+
+            // only the module path, which was declared up front
+            bool visit_import(NodeId, const Node&) {
+                return false;
+            }
+
+            // the left side is an ordinary expression, the right side is a member of it
+            bool visit_scope(NodeId id, const Node& node) {
+                if (this->sema.context[id].role == Role::NAME)
+                    return false;
+
+                this->set(node.second, Role::ACCESS, id);
+                return true;
+            }
+
+            // a.b(c): `b` is the member, `c` is resolved as usual
+            bool visit_call(NodeId id, const Node& node) {
+                if (this->sema.context[id].role == Role::ACCESS)
+                    this->set(node.first, Role::ACCESS, this->sema.context[id].owner);
+                return true;
+            }
+
+            bool visit_variable(NodeId id, const Node& node) {
+                Context context = this->sema.context[id];
+
+                if (context.role == Role::NAME)
+                    return false;
+
+                // members can only be looked up once the left side is known to be an
+                // enum, anything else has to wait for types
+                if (context.role == Role::ACCESS) {
+                    NodeId owner = this->sema.resolved[this->ast.get(context.owner).first];
+
+                    if (owner != NO_NODE && owner != BUILTIN && this->ast.get(owner).kind == NodeKind::ENUM) {
+                        NodeId member = this->sema.members.get(owner, node.text);
+
+                        if (member == NO_NODE) {
+                            std::string_view text = Interner::text(node.text);
+                            this->diagnostics->report("'" + std::string(Interner::text(this->ast.get(owner).text)) + "' has no member '" + std::string(text) + "'",
+                                                      this->ast, id, text.length());
+                        }
+
+                        this->sema.resolved[id] = member;
+                        this->sema.resolved[context.owner] = member;
+                    }
+
+                    return false;
+                }
+
+                NodeId decl = this->scopes.lookup(node.text);
+                this->uses++;
+
+                if (decl == NO_NODE) {
+                    std::string_view text = Interner::text(node.text);
+                    this->diagnostics->report("Undefined name '" + std::string(text) + "'", this->ast, id, text.length());
+                }
+
+                this->sema.resolved[id] = decl;
+                return false;
+            }
+
+            void leave(NodeId id) {
+                const Node& node = this->ast.get(id);
+
+                switch (node.kind) {
+
+                    case NodeKind::BLOCK:
+                    case NodeKind::C_FOR:
+                    case NodeKind::FINN_FOR:
+                    case NodeKind::INTERFACE: {
+                        this->scopes.pop();
+                        break;
+                    }
+
+                    case NodeKind::FUNC: {
+                        const uint32_t* parts = this->ast.extra_data(node.second);
+
+                        this->sema.declared[id] = this->annotations(parts[1]);
+                        if (parts[2] != Ast::EMPTY_LIST)
+                            this->sema.thrown[id] = this->annotations(parts[2]);
+
+                        this->scopes.pop();
+                        break;
+                    }
+
+                    // declared once the value is done, so `let x = x` means the outer x
+                    case NodeKind::MUTABLE:
+                    case NodeKind::CONSTANT: {
+                        Context context = this->sema.context[id];
+                        TypeId type = this->annotations(node.first);
+                        this->sema.declared[id] = type;
+
+                        // a value the parser filled in isn't the user's
+                        bool written = node.second != NO_NODE && this->ast.loc(node.second).valid();
+
+                        TypeId value = written ? this->literal_type(node.second) : NO_TYPE;
+                        if (type != NO_TYPE && value != NO_TYPE && !this->sema.types.subsumes(type, value)) {
+                            this->diagnostics->report("Cannot use a " + this->sema.types.spelling(value) + " value as " + this->sema.types.spelling(type),
+                                                      this->ast, node.second);
+                        }
+
+                        if (context.role == Role::MEMBER) {
+                            if (this->sema.members.add(context.owner, node.text, id) != NO_NODE)
+                                this->redeclared(id, node.text);
+                        } else {
+                            this->declare(id, node.text);
+                        }
+                        break;
+                    }
+
+                    default: {
+                        break;
+                    }
+
+                }
+            }
+    };
+
+    // the second pass. threads take the next body off a shared counter rather
+    // than being handed a fixed share, so a few huge functions don't leave the
+    // rest of them idle
+    void check_bodies(void) {
+        std::vector<Diagnostics> found(this->bodies.size(), Diagnostics(this->diagnostics.get_limit()));
+        size_t threads = std::min(this->jobs, this->bodies.size());
+
+        if (threads <= 1) {
+            Walker walker(*this, false);
+            for (size_t i = 0; i < this->bodies.size(); i++)
+                walker.check(this->bodies[i], found[i]);
+            this->uses += walker.uses;
+        } else {
+            std::atomic<size_t> next(0);
+            std::vector<size_t> counts(threads, 0);
+
+            ThreadPool pool(threads);
+
+            for (size_t t = 0; t < threads; t++) {
+                pool.submit([&, t]() {
+                    Walker walker(*this, false);
+
+                    for (size_t i = next++; i < this->bodies.size(); i = next++)
+                        walker.check(this->bodies[i], found[i]);
+
+                    counts[t] = walker.uses;
+                });
+            }
+
+            pool.wait();
+
+            for (size_t count : counts)
+                this->uses += count;
+        }
+
+        for (const Diagnostics& body : found)
+            this->diagnostics.append(body);
+    }
+
+    public:
+        // resolved[] for names that aren't declared in the file at all but are
+        // always there
+        static constexpr NodeId BUILTIN = UINT32_MAX - 1;
+
+        SemaAnalyser(const Ast& ast, const std::vector<NodeId>& statements, Diagnostics& diagnostics, size_t jobs = 1)
+          : ast(ast), statements(statements), diagnostics(diagnostics), jobs(std::max<size_t>(jobs, 1)) {}
+
+        void begin_analysis(void) {
+            this->context.assign(this->ast.size(), Context{});
+            this->resolved.assign(this->ast.size(), NO_NODE);
+            this->declared.assign(this->ast.size(), NO_TYPE);
+            this->thrown.assign(this->ast.size(), NO_TYPE);
+
+            Walker walker(*this, true);
+
+            for (NodeId statement : this->statements)
+                walker.hoist(statement);
+
+            for (NodeId statement : this->statements)
+                walker.walk(statement);
+
+            this->uses += walker.uses;
+            this->check_bodies();
+        }
+
+        // the declaration a name refers to, NO_NODE if it couldn't be resolved
+        NodeId resolution(NodeId id) const { return this->resolved[id]; }
+
+        size_t resolved_uses(void) const { return this->uses; }
+
+        size_t body_count(void) const { return this->bodies.size(); }
+
+        // the annotated type of a let, const, argument or member, the return type
+        // of a function, or the type a struct, enum or interface declares.
+        // NO_TYPE when there's no annotation
+        TypeId declared_type(NodeId id) const { return this->declared[id]; }
+
+        TypeId thrown_type(NodeId func) const { return this->thrown[func]; }
+
+        TypeTable& type_table(void) { return this->types; }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,576 @@
+#ifndef SERIALIZE_HPP
+#define SERIALIZE_HPP
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+#include "output.hpp"
+#include "ast.hpp"
+#include "intern.hpp"
+#include "literal.hpp"
+#include "operators.hpp"
+
+// writes an Ast out in one pass straight into an Output. there are three formats:
+//
+//   text     the indented Expr.Binary( ... ) dump, one node per line
+//   compact  one s-expression per statement, (binary + a (call f [1 2]))
+//   binary   the node pools as they are in memory, see binary()
+//
+// text and compact go through a work stack the same way Ast::walk does, so
+// nesting depth doesn't matter
+class AstWriter {
+    // a piece of output still to come. either a node, or when `open` is set a
+    // single piece of text
+    struct Piece {
+        NodeId           node;
+        int              indent;
+        const char*      open  = nullptr;
+        std::string_view text  = {};
+        const char*      close = "";
+    };
+
+    typedef void (AstWriter::*Expand)(NodeId, int);
+
+    const Ast& ast;
+    Output&    out;
+
+    std::vector<Piece> work;
+    std::vector<Piece> plan;
+
+    public:
+        AstWriter(const Ast& ast, Output& out) : ast(ast), out(out) {}
+
+        void text(NodeId root) {
+            this->drain<&AstWriter::expand_text>(root);
+        }
+
+        void compact(NodeId root) {
+            this->drain<&AstWriter::expand_compact>(root);
+        }
+
+        // little endian hosts only, the pools go out as they are in memory:
+        //
+        //   "FINNAST" 0x02
+        //   u32 count, then that many symbols as u32 length + bytes
+        //   u32 count, 16 byte nodes
+        //   u32 count, u32 node offsets into the file (0xFFFFFFFF for none)
+        //   u32 count, u32 extra
+        //   u32 count, 16 byte integers
+        //   u32 count, f64 floats
+        //   u32 count, u32 top level statements
+        void binary(const std::vector<NodeId>& statements) {
+            this->out.write("FINNAST\x02", 8);
+
+            uint32_t symbols = Interner::size();
+            this->out.raw(symbols);
+
+            for (SymbolId id = 0; id < symbols; id++) {
+                std::string_view text = Interner::text(id);
+                this->out.raw(static_cast<uint32_t>(text.length()));
+                this->out.write(text);
+            }
+
+            this->out.raw(this->ast.node_pool());
+            this->out.raw(this->ast.loc_pool());
+            this->out.raw(this->ast.extra_pool());
+            this->out.raw(this->ast.integer_pool());
+            this->out.raw(this->ast.float_pool());
+            this->out.raw(statements);
+        }
+
+    private:
+        template<Expand expand>
+        void drain(NodeId root) {
+            this->work.push_back(Piece{root, 0});
+
+            while (!this->work.empty()) {
+                Piece piece = this->work.back();
+                this->work.pop_back();
+
+                if (piece.open != nullptr) {
+                    this->out.spaces(piece.indent);
+                    this->out.write(piece.open);
+                    this->out.write(piece.text);
+                    this->out.write(piece.close);
+                    continue;
+                }
+
+                this->plan.clear();
+                (this->*expand)(piece.node, piece.indent);
+                this->work.insert(this->work.end(), this->plan.rbegin(), this->plan.rend());
+            }
+        }
+
+        void line(int indent, const char* open, std::string_view text = {}, const char* close = "") {
+            this->plan.push_back(Piece{NO_NODE, indent, open, text, close});
+        }
+
+        void child(NodeId id, int indent) {
+            this->plan.push_back(Piece{id, indent});
+        }
+
+        void children(uint32_t list, int indent) {
+            for (NodeId item : this->ast.list(list))
+                this->child(item, indent);
+        }
+
+        // the "Label(" ... ")" wrapper only goes out when the list has something in it
+        void wrapped(const char* label, uint32_t list, int indent) {
+            if (this->ast.list(list).empty())
+                return;
+
+            this->line(indent, label, {}, "(\n");
+            this->children(list, indent + 2);
+            this->line(indent, ")\n");
+        }
+
+        // writes the first line of a node straight away, and leaves everything
+        // after it in `plan` in the order it has to come out
+        void expand_text(NodeId id, int indent) {
+            const Node& node = this->ast.get(id);
+            Output& out = this->out;
+
+            switch (node.kind) {
+
+                case NodeKind::BINARY: {
+                    out.spaces(indent); out.write("Expr.Binary(\n");
+                    this->child(node.first, indent + 2);
+                    this->line(indent + 2, "Token(", Operators::spelling(node.token_type()), ")\n");
+                    this->child(node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::SUFFIX:
+                case NodeKind::PREFIX: {
+                    out.spaces(indent); out.write(node.kind == NodeKind::SUFFIX ? "Expr.Suffix(\n" : "Expr.Prefix(\n");
+                    this->child(node.first, indent + 2);
+                    this->line(indent + 2, "Token(", Operators::spelling(node.token_type()), ")\n");
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::SCOPE: {
+                    out.spaces(indent); out.write("Expr.Scope(\n");
+                    this->child(node.first, indent + 2);
+                    this->child(node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::CALL: {
+                    out.spaces(indent); out.write("Expr.Call(\n");
+                    this->child(node.first, indent + 2);
+                    this->wrapped("Args", node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::GROUPING: {
+                    out.spaces(indent); out.write("Expr.Grouping(\n");
+                    this->child(node.first, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::NIL: {
+                    out.spaces(indent); out.write("Expr.Literal(nil)\n");
+                    break;
+                }
+
+                case NodeKind::FLOAT_LIT: {
+                    out.spaces(indent); out.write("Expr.Literal("); out.number(this->ast.floating(node)); out.write(")\n");
+                    break;
+                }
+
+                case NodeKind::INT_LIT: {
+                    out.spaces(indent); out.write("Expr.Literal("); out.write(Literal::to_string(this->ast.integer(node))); out.write(")\n");
+                    break;
+                }
+
+                case NodeKind::BOOL_LIT: {
+                    out.spaces(indent); out.write(node.first ? "Expr.Literal(true)\n" : "Expr.Literal(false)\n");
+                    break;
+                }
+
+                case NodeKind::STRING_LIT: {
+                    out.spaces(indent); out.write("Expr.Literal(\""); out.write(Interner::text(node.text)); out.write("\")\n");
+                    break;
+                }
+
+                case NodeKind::TYPE: {
+                    out.spaces(indent); out.write("Expr.Type("); out.write(Interner::text(node.text)); out.write(")\n");
+                    break;
+                }
+
+                case NodeKind::VARIABLE: {
+                    out.spaces(indent); out.write("Expr.Variable("); out.write(Interner::text(node.text)); out.write(")\n");
+                    break;
+                }
+
+                case NodeKind::REASSIGN: {
+                    out.spaces(indent); out.write("Expr.Reassign(\n");
+                    this->child(node.first, indent + 2);
+                    this->child(node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::EXPRESSION: {
+                    out.spaces(indent); out.write("Stmt.Expression(\n");
+                    this->child(node.first, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::MUTABLE:
+                case NodeKind::CONSTANT: {
+                    out.spaces(indent); out.write(node.kind == NodeKind::MUTABLE ? "Stmt.Mutable(\n" : "Stmt.Constant(\n");
+                    out.spaces(indent + 2); out.write("Name("); out.write(Interner::text(node.text)); out.write(")\n");
+                    this->wrapped("Types", node.first, indent + 2);
+                    if (node.second != NO_NODE)
+                        this->child(node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::IF: {
+                    const uint32_t* branches = this->ast.extra_data(node.second);
+
+                    out.spaces(indent); out.write("Stmt.If(\n");
+                    this->child(node.first, indent + 2);
+                    this->child(branches[0], indent + 2);
+                    if (branches[1] != NO_NODE)
+                        this->child(branches[1], indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::WHILE: {
+                    out.spaces(indent); out.write("Stmt.While(\n");
+                    this->child(node.first, indent + 2);
+                    this->child(node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::BLOCK: {
+                    out.spaces(indent); out.write("Stmt.Block(\n");
+                    this->children(node.first, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::C_FOR: {
+                    const uint32_t* parts = this->ast.extra_data(node.first);
+
+                    out.spaces(indent); out.write("Stmt.For(\n");
+                    for (int i = 0; i < 4; i++)
+                        this->child(parts[i], indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::FINN_FOR: {
+                    const uint32_t* parts = this->ast.extra_data(node.first);
+
+                    out.spaces(indent); out.write("Stmt.For(\n");
+                    this->child(parts[0], indent + 2);
+                    this->line(indent + 2, "Types(\n");
+                    this->children(parts[1], indent + 4);
+                    this->line(indent + 2, ")\n");
+                    this->child(parts[2], indent + 2);
+                    this->child(parts[3], indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::INTERFACE: {
+                    out.spaces(indent); out.write("Stmt.Interface(\n");
+                    out.spaces(indent + 2); out.write("Expr.Variable("); out.write(Interner::text(node.text)); out.write(")\n");
+                    this->children(node.first, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::ENUM: {
+                    out.spaces(indent); out.write("Stmt.Enum(\n");
+                    out.spaces(indent + 2); out.write("Expr.Variable("); out.write(Interner::text(node.text)); out.write(")\n");
+                    this->children(node.first, indent + 2);
+                    this->children(node.second, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::FUNC: {
+                    const uint32_t* parts = this->ast.extra_data(node.second);
+
+                    out.spaces(indent); out.write("Stmt.Func(\n");
+                    this->child(node.first, indent + 2);
+                    this->wrapped("Args", parts[0], indent + 2);
+                    this->wrapped("Types", parts[1], indent + 2);
+                    this->wrapped("Types", parts[2], indent + 2);
+                    this->child(parts[3], indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::THROW:
+                case NodeKind::RETURN:
+                case NodeKind::IMPORT: {
+                    out.spaces(indent);
+                    out.write(node.kind == NodeKind::THROW ? "Stmt.Throw(\n" : node.kind == NodeKind::RETURN ? "Stmt.Return(\n" : "Stmt.Import(\n");
+                    this->child(node.first, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::STRUCT: {
+                    out.spaces(indent); out.write("Stmt.Struct(\n");
+                    out.spaces(indent + 2); out.write("Token("); out.write(Interner::text(node.text)); out.write(")\n");
+                    this->children(node.first, indent + 2);
+                    this->line(indent, ")\n");
+                    break;
+                }
+
+                case NodeKind::LAZY_BODY: {
+                    out.spaces(indent); out.write("Stmt.Block(not parsed)\n");
+                    break;
+                }
+
+            }
+        }
+
+        // compact pieces never indent, children are separated by a space and a
+        // missing one is written as _
+        void item(NodeId id) {
+            if (id == NO_NODE)
+                this->line(0, " _");
+            else {
+                this->line(0, " ");
+                this->child(id, 0);
+            }
+        }
+
+        void items(uint32_t list) {
+            Span<const NodeId> items = this->ast.list(list);
+
+            this->line(0, " [");
+            for (size_t i = 0; i < items.size(); i++) {
+                if (i > 0)
+                    this->line(0, " ");
+                this->child(items[i], 0);
+            }
+            this->line(0, "]");
+        }
+
+        void expand_compact(NodeId id, int) {
+            const Node& node = this->ast.get(id);
+            Output& out = this->out;
+
+            switch (node.kind) {
+
+                case NodeKind::BINARY: {
+                    out.write("(binary "); out.write(Operators::spelling(node.token_type()));
+                    this->item(node.first);
+                    this->item(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::SUFFIX:
+                case NodeKind::PREFIX: {
+                    out.write(node.kind == NodeKind::SUFFIX ? "(suffix " : "(prefix "); out.write(Operators::spelling(node.token_type()));
+                    this->item(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::SCOPE: {
+                    out.write("(scope");
+                    this->item(node.first);
+                    this->item(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::CALL: {
+                    out.write("(call");
+                    this->item(node.first);
+                    this->items(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::GROUPING: {
+                    out.write("(group");
+                    this->item(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::NIL: {
+                    out.write("nil");
+                    break;
+                }
+
+                case NodeKind::FLOAT_LIT: {
+                    out.number(this->ast.floating(node));
+                    break;
+                }
+
+                case NodeKind::INT_LIT: {
+                    out.write(Literal::to_string(this->ast.integer(node)));
+                    break;
+                }
+
+                case NodeKind::BOOL_LIT: {
+                    out.write(node.first ? "true" : "false");
+                    break;
+                }
+
+                case NodeKind::STRING_LIT: {
+                    out.put('"'); out.write(Interner::text(node.text)); out.put('"');
+                    break;
+                }
+
+                case NodeKind::TYPE: {
+                    out.write("(type "); out.write(Interner::text(node.text)); out.put(')');
+                    break;
+                }
+
+                case NodeKind::VARIABLE: {
+                    out.write(Interner::text(node.text));
+                    break;
+                }
+
+                case NodeKind::REASSIGN: {
+                    out.write("(assign");
+                    this->item(node.first);
+                    this->item(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::EXPRESSION: {
+                    out.write("(expression");
+                    this->item(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::MUTABLE:
+                case NodeKind::CONSTANT: {
+                    out.write(node.kind == NodeKind::MUTABLE ? "(let " : "(const "); out.write(Interner::text(node.text));
+                    this->items(node.first);
+                    this->item(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::IF: {
+                    const uint32_t* branches = this->ast.extra_data(node.second);
+
+                    out.write("(if");
+                    this->item(node.first);
+                    this->item(branches[0]);
+                    this->item(branches[1]);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::WHILE: {
+                    out.write("(while");
+                    this->item(node.first);
+                    this->item(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::BLOCK: {
+                    out.write("(block");
+                    this->items(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::C_FOR: {
+                    const uint32_t* parts = this->ast.extra_data(node.first);
+
+                    out.write("(for");
+                    for (int i = 0; i < 4; i++)
+                        this->item(parts[i]);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::FINN_FOR: {
+                    const uint32_t* parts = this->ast.extra_data(node.first);
+
+                    out.write("(for-in");
+                    this->item(parts[0]);
+                    this->items(parts[1]);
+                    this->item(parts[2]);
+                    this->item(parts[3]);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::INTERFACE: {
+                    out.write("(interface "); out.write(Interner::text(node.text));
+                    this->items(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::ENUM: {
+                    out.write("(enum "); out.write(Interner::text(node.text));
+                    this->items(node.first);
+                    this->items(node.second);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::FUNC: {
+                    const uint32_t* parts = this->ast.extra_data(node.second);
+
+                    out.write("(func");
+                    this->item(node.first);
+                    this->items(parts[0]);
+                    this->items(parts[1]);
+                    this->items(parts[2]);
+                    this->item(parts[3]);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::THROW:
+                case NodeKind::RETURN:
+                case NodeKind::IMPORT: {
+                    out.write(node.kind == NodeKind::THROW ? "(throw" : node.kind == NodeKind::RETURN ? "(return" : "(import");
+                    this->item(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::STRUCT: {
+                    out.write("(struct "); out.write(Interner::text(node.text));
+                    this->items(node.first);
+                    this->line(0, ")");
+                    break;
+                }
+
+                case NodeKind::LAZY_BODY: {
+                    out.write("(lazy)");
+                    break;
+                }
+
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef SOURCE_HPP
+#define SOURCE_HPP
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define FINN_HAS_MMAP
+#endif
+
+// where something is in a file, as a 32 bit byte offset. which file it's in comes
+// from whatever holds it (a token buffer, an Ast). line and column are only worked
+// out from the line table when a diagnostic gets rendered. offsets that don't fit,
+// past 4GB, come out as NONE and are reported without a position
+struct SourceLoc {
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t offset = NONE;
+
+    static SourceLoc at(size_t offset) {
+        return SourceLoc{offset < NONE ? static_cast<uint32_t>(offset) : NONE};
+    }
+
+    bool valid(void) const { return this->offset != NONE; }
+};
+
+// a run of bytes starting at a SourceLoc, eg. a token's lexeme
+struct SourceRange {
+    SourceLoc begin;
+    uint32_t  length = 0;
+};
+
+// a single source buffer, either owned or mapped straight from disk. tokens
+// slice into `contents`, so a SourceFile has to outlive everything lexed from it.
+// offsets into it are 64 bit, files past 4GB are fine
+class SourceFile {
+    std::string name;
+    std::string owned;
+
+    const char* mapping = nullptr;
+    size_t      mapping_size = 0;
+
+    std::string_view contents;
+
+    // offset of the first byte of every line. the lexer records these as it
+    // goes and hands them over with set_line_starts, anything that asks before
+    // then (or without lexing) gets them from a scan of its own
+    mutable std::vector<size_t> line_starts;
+
+    void build_line_starts(void) const {
+        this->line_starts.push_back(0);
+        for (size_t i = 0; i < this->contents.length(); i++)
+            if (this->contents[i] == '\n')
+                this->line_starts.push_back(i + 1);
+    }
+
+    size_t line_index(size_t offset) const {
+        if (this->line_starts.empty())
+            this->build_line_starts();
+        return std::upper_bound(this->line_starts.begin(), this->line_starts.end(), offset) - this->line_starts.begin() - 1;
+    }
+
+    public:
+        SourceFile(std::string name, std::string source)
+          : name(std::move(name)), owned(std::move(source)) {
+            this->contents = std::string_view(this->owned);
+        }
+
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+
+        ~SourceFile() {
+#ifdef FINN_HAS_MMAP
+            if (this->mapping != nullptr)
+                munmap(const_cast<char*>(this->mapping), this->mapping_size);
+#endif
+        }
+
+        // returns nullptr if the file can't be mapped, the caller falls back to reading it
+        static std::unique_ptr<SourceFile> map(const std::string& name) {
+#ifdef FINN_HAS_MMAP
+            int fd = open(name.c_str(), O_RDONLY);
+            if (fd == -1)
+                return nullptr;
+
+            struct stat info;
+            if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+                close(fd);
+                return nullptr;
+            }
+
+            std::unique_ptr<SourceFile> file(new SourceFile(name, ""));
+
+            if (info.st_size > 0) {
+                void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    close(fd);
+                    return nullptr;
+                }
+
+                file->mapping = static_cast<const char*>(mapping);
+                file->mapping_size = info.st_size;
+                file->contents = std::string_view(file->mapping, file->mapping_size);
+
+                // the lexer goes front to back, so let the kernel read ahead of it
+                madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+            }
+
+            close(fd);
+            return file;
+#else
+            return nullptr;
+#endif
+        }
+
+        // reads the whole file into memory, for pipes and anything else mmap can't
+        // take. "-" reads stdin
+        static std::unique_ptr<SourceFile> read(const std::string& name) {
+#ifdef FINN_HAS_MMAP
+            bool is_stdin = name == "-";
+            int fd = is_stdin ? STDIN_FILENO : open(name.c_str(), O_RDONLY);
+            if (fd == -1)
+                return nullptr;
+
+            std::string source = "";
+            char chunk[1 << 16];
+
+            struct stat info;
+            if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+                source.reserve(info.st_size);
+
+            while (true) {
+                ssize_t amount = ::read(fd, chunk, sizeof(chunk));
+
+                if (amount > 0) {
+                    source.append(chunk, amount);
+                } else if (amount == 0) {
+                    break;
+                } else if (errno != EINTR) {
+                    if (!is_stdin) close(fd);
+                    return nullptr;
+                }
+            }
+
+            if (!is_stdin)
+                close(fd);
+
+            return std::make_unique<SourceFile>(is_stdin ? "<stdin>" : name, std::move(source));
+#else
+            std::ifstream file(name, std::ios::binary);
+            if (!file.is_open())
+                return nullptr;
+
+            std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            return std::make_unique<SourceFile>(name, std::move(source));
+#endif
+        }
+
+        // maps the file if it can and reads it otherwise, nullptr if it can't be opened at all
+        static std::unique_ptr<SourceFile> load(const std::string& name) {
+            std::unique_ptr<SourceFile> file = name == "-" ? nullptr : SourceFile::map(name);
+            if (file == nullptr)
+                file = SourceFile::read(name);
+            return file;
+        }
+
+        const std::string& get_name(void) const { return this->name; }
+        std::string_view get_contents(void) const { return this->contents; }
+
+        // 1 based line and column of a byte offset, the line table is built the first time either is asked for
+        int line_of(size_t offset) const {
+            return this->line_index(offset) + 1;
+        }
+
+        int column_of(size_t offset) const {
+            return offset - this->line_starts[this->line_index(offset)] + 1;
+        }
+
+        // the text of a 1 based line, without its line ending
+        std::string_view line_text(size_t line) const {
+            if (this->line_starts.empty())
+                this->build_line_starts();
+
+            size_t begin = this->line_starts[line - 1];
+            size_t end = line < this->line_starts.size() ? this->line_starts[line] : this->contents.length();
+
+            while (end > begin && (this->contents[end - 1] == '\n' || this->contents[end - 1] == '\r'))
+                end--;
+
+            return this->contents.substr(begin, end - begin);
+        }
+
+        void set_line_starts(std::vector<size_t> starts) {
+            this->line_starts = std::move(starts);
+        }
+};
+
+// process wide table of every loaded file, tokens only carry the file id
+class SourceManager {
+    inline static std::vector<std::unique_ptr<SourceFile>> files = {};
+
+    public:
+        static uint32_t add(std::string name, std::string source) {
+            files.push_back(std::make_unique<SourceFile>(std::move(name), std::move(source)));
+            return files.size() - 1;
+        }
+
+        static uint32_t add(std::unique_ptr<SourceFile> file) {
+            files.push_back(std::move(file));
+            return files.size() - 1;
+        }
+
+        static const SourceFile& get(uint32_t file_id) {
+            return *files[file_id];
+        }
+
+        static void set_line_starts(uint32_t file_id, std::vector<size_t> starts) {
+            files[file_id]->set_line_starts(std::move(starts));
+        }
+};
+
+#endif
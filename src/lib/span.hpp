@@ -0,0 +1,28 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#pragma once
+
+#include <cstddef>
+
+// a view of a run of items stored in someone else's vector, what the AST and
+// the type table hand out instead of copying lists of children or members
+template<typename T>
+class Span {
+    T*     items = nullptr;
+    size_t count = 0;
+
+    public:
+        Span(void) = default;
+        Span(T* items, size_t count) : items(items), count(count) {}
+
+        T* begin(void) const { return this->items; }
+        T* end(void) const { return this->items + this->count; }
+
+        size_t size(void) const { return this->count; }
+        bool empty(void) const { return this->count == 0; }
+
+        T& operator[](size_t index) const { return this->items[index]; }
+};
+
+#endif
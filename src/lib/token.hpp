@@ -4,7 +4,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include <initializer_list>
+#include <algorithm>
+
+#include "source.hpp"
 
 typedef enum {
     STRING = 0,
@@ -134,26 +140,138 @@ typedef enum {
     END_OF_FILE // for some reason g++ panics when you have "EOF" as a value
 } TokenType;
 
-struct Position {
-    int line;
-    std::vector<int> offset;
-};
-
+// a view of a single entry in a TokenBuffer. it's cheap to copy and only built
+// when somebody asks for it, the buffer itself never stores one
 struct Token {
     TokenType        token_type;
-    std::string      lexeme;
-    TokenType        data_type;
-    Position         position;
-    std::string      filename;
+    std::string_view lexeme;
+    size_t           offset;
+    uint32_t         file_id;
+
+    SourceLoc loc(void) const { return SourceLoc::at(this->offset); }
 
-    std::string dump(int indent = 0) {
+    SourceRange range(void) const { return SourceRange{this->loc(), static_cast<uint32_t>(this->lexeme.length())}; }
+
+    std::string dump(int indent = 0) const {
         std::string root = ""; 
         
         for (int i = 1; i <= indent; i++)
-            root += " "; root += "Token(" + this->lexeme + ")\n";
+            root += " "; root += "Token(" + std::string(this->lexeme) + ")\n";
 
         return root;
     }
 };
 
+// a token as the lexer hands it over, before it's stored anywhere
+struct TokenEntry {
+    TokenType token_type;
+    size_t    offset;
+    uint32_t  length;
+};
+
+static_assert(TokenType::END_OF_FILE <= UINT8_MAX, "token kinds have to fit in the uint8_t kind array");
+
+// a set of token kinds as a 256 bit mask. it can be built at compile time,
+// and checking a kind against it is a shift and an and
+class TokenSet {
+    uint64_t words[4] = {};
+
+    public:
+        constexpr TokenSet(void) = default;
+
+        constexpr TokenSet(std::initializer_list<TokenType> token_types) {
+            for (TokenType token_type : token_types)
+                this->words[token_type >> 6] |= static_cast<uint64_t>(1) << (token_type & 63);
+        }
+
+        constexpr bool has(TokenType token_type) const {
+            return (this->words[token_type >> 6] >> (token_type & 63)) & 1;
+        }
+};
+
+// structure of arrays token stream: one byte of kind plus a 32 bit offset and
+// length per token, lexemes are sliced out of the source file when asked for.
+// offsets only keep their low 32 bits, `wraps` holds the index of the first
+// token past each 4GB line so the high bits can be put back. it's empty for
+// anything smaller than that
+class TokenBuffer {
+    uint32_t         file_id;
+    std::string_view source;
+
+    std::vector<uint8_t>  kinds;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<size_t>   wraps;
+
+    public:
+        explicit TokenBuffer(uint32_t file_id)
+          : file_id(file_id), source(SourceManager::get(file_id).get_contents()) {}
+
+        void reserve(size_t amount) {
+            this->kinds.reserve(amount);
+            this->offsets.reserve(amount);
+            this->lengths.reserve(amount);
+        }
+
+        void push(TokenType token_type, size_t offset, uint32_t length) {
+            while ((offset >> 32) > this->wraps.size())
+                this->wraps.push_back(this->kinds.size());
+
+            this->kinds.push_back(static_cast<uint8_t>(token_type));
+            this->offsets.push_back(offset);
+            this->lengths.push_back(length);
+        }
+
+        void push(const TokenEntry& entry) {
+            this->push(entry.token_type, entry.offset, entry.length);
+        }
+
+        // other has to come after everything already in this buffer
+        void append(const TokenBuffer& other) {
+            for (size_t i = this->wraps.size(); i < other.wraps.size(); i++)
+                this->wraps.push_back(other.wraps[i] + this->kinds.size());
+
+            this->kinds.insert(this->kinds.end(), other.kinds.begin(), other.kinds.end());
+            this->offsets.insert(this->offsets.end(), other.offsets.begin(), other.offsets.end());
+            this->lengths.insert(this->lengths.end(), other.lengths.begin(), other.lengths.end());
+        }
+
+        size_t size(void) const { return this->kinds.size(); }
+
+        uint32_t get_file_id(void) const { return this->file_id; }
+
+        TokenType kind(size_t index) const { return static_cast<TokenType>(this->kinds[index]); }
+
+        size_t offset(size_t index) const {
+            if (this->wraps.empty())
+                return this->offsets[index];
+
+            size_t high = std::upper_bound(this->wraps.begin(), this->wraps.end(), index) - this->wraps.begin();
+            return (high << 32) | this->offsets[index];
+        }
+
+        SourceLoc loc(size_t index) const { return SourceLoc::at(this->offset(index)); }
+
+        std::string_view lexeme(size_t index) const {
+            return this->source.substr(this->offset(index), this->lengths[index]);
+        }
+
+        Token get(size_t index) const {
+            return Token{this->kind(index), this->lexeme(index), this->offset(index), this->file_id};
+        }
+
+        // what the arrays have allocated, spare capacity included, per token
+        double bytes_per_token(void) const {
+            if (this->kinds.empty())
+                return 0;
+
+            size_t bytes = this->kinds.capacity() * sizeof(uint8_t)
+                         + this->offsets.capacity() * sizeof(uint32_t)
+                         + this->lengths.capacity() * sizeof(uint32_t)
+                         + this->wraps.capacity() * sizeof(size_t);
+
+            return static_cast<double>(bytes) / this->kinds.size();
+        }
+};
+
 #endif
@@ -0,0 +1,331 @@
+#ifndef TYPES_HPP
+#define TYPES_HPP
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+#include "token.hpp"
+#include "intern.hpp"
+#include "span.hpp"
+#include "ast.hpp"
+
+typedef uint32_t TypeId;
+
+constexpr TypeId NO_TYPE = UINT32_MAX;
+
+enum class TypeKind : uint8_t {
+    ERROR,      // something that isn't a type was used as one, it matches anything so it's only reported once
+    NIL,
+    PRIMITIVE,  // op = the type keyword
+    NAMED,      // first = declaring node, second = name
+    POINTER,    // first = what it points to
+    UNION,      // first = index into `members`, second = how many
+};
+
+struct Type {
+    TypeKind kind;
+    uint8_t  op;
+    uint16_t padding;
+    uint32_t first;
+    uint32_t second;
+};
+
+// every distinct type exists once and is known by its TypeId, so two types are
+// the same exactly when their ids are. unions are flattened, sorted by id and
+// deduplicated before they're looked up, which makes `int | nil` and
+// `nil | int | int` the same type. it can be shared between threads, everything
+// that can add a type or an answer takes the lock. get() and union_members()
+// don't, the references they give out could move if another thread interns
+class TypeTable {
+    static constexpr TypeId EMPTY = UINT32_MAX;
+
+    mutable std::mutex mutex;
+
+    std::vector<Type>     types;
+    std::vector<uint32_t> hashes;
+    std::vector<TypeId>   slots = std::vector<TypeId>(256, EMPTY);
+    std::vector<TypeId>   members;
+    std::vector<TypeId>   flat;
+
+    // subsumes() answers, keyed by both ids, so asking again is one probe
+    struct Answer {
+        uint64_t key = UINT64_MAX;
+        bool     yes = false;
+    };
+
+    std::vector<Answer> answers = std::vector<Answer>(1024);
+    size_t              answered = 0;
+
+    TypeId error_type;
+    TypeId nil_type;
+
+    // the builtin types are made up front, so asking for one doesn't need the lock
+    TypeId primitives[TokenType::STR - TokenType::INT_TYPE + 1];
+
+    static uint32_t mix(uint32_t hash, uint32_t value) {
+        return (hash ^ value) * 16777619u;
+    }
+
+    uint32_t hash(const Type& type, const TypeId* items) const {
+        uint32_t hash = mix(mix(2166136261u, static_cast<uint32_t>(type.kind)), type.op);
+
+        if (type.kind == TypeKind::UNION) {
+            for (uint32_t i = 0; i < type.second; i++)
+                hash = mix(hash, items[i]);
+            return hash;
+        }
+
+        return mix(mix(hash, type.first), type.second);
+    }
+
+    bool same(TypeId id, const Type& type, const TypeId* items) const {
+        const Type& other = this->types[id];
+
+        if (other.kind != type.kind || other.op != type.op)
+            return false;
+
+        if (type.kind == TypeKind::UNION)
+            return other.second == type.second && std::equal(items, items + type.second, this->members.begin() + other.first);
+
+        return other.first == type.first && other.second == type.second;
+    }
+
+    void grow(void) {
+        std::vector<TypeId> bigger(this->slots.size() * 2, EMPTY);
+        size_t mask = bigger.size() - 1;
+
+        for (TypeId id = 0; id < this->types.size(); id++) {
+            size_t slot = this->hashes[id] & mask;
+            while (bigger[slot] != EMPTY)
+                slot = (slot + 1) & mask;
+            bigger[slot] = id;
+        }
+
+        this->slots = std::move(bigger);
+    }
+
+    // `items` are only read for unions, and copied into `members` if it's new
+    TypeId intern(Type type, const TypeId* items = nullptr) {
+        uint32_t type_hash = this->hash(type, items);
+        size_t mask = this->slots.size() - 1;
+        size_t slot = type_hash & mask;
+
+        while (this->slots[slot] != EMPTY) {
+            TypeId id = this->slots[slot];
+            if (this->hashes[id] == type_hash && this->same(id, type, items))
+                return id;
+            slot = (slot + 1) & mask;
+        }
+
+        if (type.kind == TypeKind::UNION) {
+            type.first = this->members.size();
+            this->members.insert(this->members.end(), items, items + type.second);
+        }
+
+        TypeId id = this->types.size();
+        this->types.push_back(type);
+        this->hashes.push_back(type_hash);
+        this->slots[slot] = id;
+
+        // keep the table at most half full
+        if (this->types.size() * 2 > this->slots.size())
+            this->grow();
+
+        return id;
+    }
+
+    bool contains(TypeId type_union, TypeId member) const {
+        Span<const TypeId> items = this->union_members(type_union);
+        return std::binary_search(items.begin(), items.end(), member);
+    }
+
+    bool work_out(TypeId wide, TypeId narrow) const {
+        const Type& outer = this->types[wide];
+        const Type& inner = this->types[narrow];
+
+        if (outer.kind != TypeKind::UNION)
+            return false;
+
+        if (inner.kind != TypeKind::UNION)
+            return this->contains(wide, narrow);
+
+        // both sorted, so it's one merge like pass
+        Span<const TypeId> big = this->union_members(wide);
+        Span<const TypeId> small = this->union_members(narrow);
+        return std::includes(big.begin(), big.end(), small.begin(), small.end());
+    }
+
+    public:
+        TypeTable(void) {
+            this->error_type = this->intern(Type{TypeKind::ERROR, 0, 0, 0, 0});
+            this->nil_type = this->intern(Type{TypeKind::NIL, 0, 0, 0, 0});
+
+            for (int keyword = TokenType::INT_TYPE; keyword <= TokenType::STR; keyword++)
+                this->primitives[keyword - TokenType::INT_TYPE] = this->intern(Type{TypeKind::PRIMITIVE, static_cast<uint8_t>(keyword), 0, 0, 0});
+        }
+
+        TypeId error(void) const { return this->error_type; }
+        TypeId nil(void) const { return this->nil_type; }
+
+        TypeId primitive(TokenType keyword) {
+            if (keyword >= TokenType::INT_TYPE && keyword <= TokenType::STR)
+                return this->primitives[keyword - TokenType::INT_TYPE];
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->intern(Type{TypeKind::PRIMITIVE, static_cast<uint8_t>(keyword), 0, 0, 0});
+        }
+
+        TypeId named(NodeId decl, SymbolId name) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->intern(Type{TypeKind::NAMED, 0, 0, decl, name});
+        }
+
+        TypeId pointer(TypeId pointee) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->intern(Type{TypeKind::POINTER, 0, 0, pointee, 0});
+        }
+
+        // one type out of any number, unions in `items` are taken apart first.
+        // anything with an error in it is just the error
+        TypeId union_of(const TypeId* items, size_t count) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            std::vector<TypeId>& flat = this->flat;
+            flat.clear();
+
+            for (size_t i = 0; i < count; i++) {
+                if (items[i] == this->error_type)
+                    return this->error_type;
+
+                if (this->types[items[i]].kind == TypeKind::UNION) {
+                    Span<const TypeId> inner = this->union_members(items[i]);
+                    flat.insert(flat.end(), inner.begin(), inner.end());
+                } else {
+                    flat.push_back(items[i]);
+                }
+            }
+
+            std::sort(flat.begin(), flat.end());
+            flat.erase(std::unique(flat.begin(), flat.end()), flat.end());
+
+            if (flat.empty())
+                return NO_TYPE;
+            if (flat.size() == 1)
+                return flat[0];
+
+            return this->intern(Type{TypeKind::UNION, 0, 0, 0, static_cast<uint32_t>(flat.size())}, flat.data());
+        }
+
+        const Type& get(TypeId id) const { return this->types[id]; }
+
+        size_t size(void) const { return this->types.size(); }
+
+        Span<const TypeId> union_members(TypeId id) const {
+            const Type& type = this->types[id];
+            return Span<const TypeId>(this->members.data() + type.first, type.second);
+        }
+
+        // whether a value of type `narrow` can go where `wide` is expected: the
+        // same type, or a union holding all of it. the error type fits both ways.
+        // only unions take any work, and every pair is only worked out once
+        bool subsumes(TypeId wide, TypeId narrow) {
+            if (wide == narrow || wide == this->error_type || narrow == this->error_type)
+                return true;
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+            uint64_t key = (static_cast<uint64_t>(wide) << 32) | narrow;
+            size_t mask = this->answers.size() - 1;
+            size_t slot = ((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+            while (this->answers[slot].key != UINT64_MAX) {
+                if (this->answers[slot].key == key)
+                    return this->answers[slot].yes;
+                slot = (slot + 1) & mask;
+            }
+
+            bool yes = this->work_out(wide, narrow);
+            this->answers[slot] = Answer{key, yes};
+
+            if (++this->answered * 2 > this->answers.size()) {
+                std::vector<Answer> old = std::move(this->answers);
+                this->answers = std::vector<Answer>(old.size() * 2);
+                this->answered = 0;
+
+                for (const Answer& answer : old)
+                    if (answer.key != UINT64_MAX)
+                        this->remember(answer);
+            }
+
+            return yes;
+        }
+
+        // how the type would be written, for diagnostics
+        std::string spelling(TypeId id) const {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->spell(id);
+        }
+
+    private:
+        std::string spell(TypeId id) const {
+            if (id == NO_TYPE)
+                return "?";
+
+            const Type& type = this->types[id];
+
+            switch (type.kind) {
+
+                case TypeKind::ERROR:     return "<error>";
+                case TypeKind::NIL:       return "nil";
+                case TypeKind::NAMED:     return std::string(Interner::text(type.second));
+                case TypeKind::POINTER:   return "*" + this->spell(type.first);
+
+                case TypeKind::PRIMITIVE: {
+                    switch (static_cast<TokenType>(type.op)) {
+                        case TokenType::INT_TYPE:    return "int";
+                        case TokenType::INT8:        return "i8";
+                        case TokenType::INT16:       return "i16";
+                        case TokenType::INT32:       return "i32";
+                        case TokenType::INT64:       return "i64";
+                        case TokenType::INT128:      return "i128";
+                        case TokenType::UINT8:       return "u8";
+                        case TokenType::UINT16:      return "u16";
+                        case TokenType::UINT32:      return "u32";
+                        case TokenType::UINT64:      return "u64";
+                        case TokenType::UINT128:     return "u128";
+                        case TokenType::BOOL_TYPE:   return "bool";
+                        case TokenType::STR:         return "string";
+                        case TokenType::FLOAT_TYPE:  return "float";
+                        case TokenType::DOUBLE_TYPE: return "double";
+                        default:                     return "<primitive>";
+                    }
+                }
+
+                case TypeKind::UNION: {
+                    std::string text = "";
+                    for (TypeId member : this->union_members(id))
+                        text += (text.empty() ? "" : " | ") + this->spell(member);
+                    return text;
+                }
+
+            }
+
+            return "?";
+        }
+
+        void remember(const Answer& answer) {
+            size_t mask = this->answers.size() - 1;
+            size_t slot = ((answer.key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+            while (this->answers[slot].key != UINT64_MAX)
+                slot = (slot + 1) & mask;
+
+            this->answers[slot] = answer;
+            this->answered++;
+        }
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef VISITOR_HPP
+#define VISITOR_HPP
+
+#pragma once
+
+#include <utility>
+
+#include "ast.hpp"
+
+// every node kind and the visit_ method it goes to
+#define NODE_KINDS(X)                \
+    X(BINARY,     visit_binary)      \
+    X(SUFFIX,     visit_suffix)      \
+    X(PREFIX,     visit_prefix)      \
+    X(SCOPE,      visit_scope)       \
+    X(CALL,       visit_call)        \
+    X(GROUPING,   visit_grouping)    \
+    X(NIL,        visit_nil)         \
+    X(FLOAT_LIT,  visit_float)       \
+    X(INT_LIT,    visit_integer)     \
+    X(BOOL_LIT,   visit_bool)        \
+    X(STRING_LIT, visit_string)      \
+    X(TYPE,       visit_type)        \
+    X(VARIABLE,   visit_variable)    \
+    X(REASSIGN,   visit_reassign)    \
+    X(EXPRESSION, visit_expression)  \
+    X(MUTABLE,    visit_mutable)     \
+    X(CONSTANT,   visit_constant)    \
+    X(IF,         visit_if)          \
+    X(WHILE,      visit_while)       \
+    X(BLOCK,      visit_block)       \
+    X(C_FOR,      visit_c_for)       \
+    X(FINN_FOR,   visit_finn_for)    \
+    X(INTERFACE,  visit_interface)   \
+    X(ENUM,       visit_enum)        \
+    X(FUNC,       visit_func)        \
+    X(THROW,      visit_throw)       \
+    X(RETURN,     visit_return)      \
+    X(STRUCT,     visit_struct)      \
+    X(IMPORT,     visit_import)      \
+    X(LAZY_BODY,  visit_lazy_body)
+
+// base for AST passes. visit() switches on the node kind and calls the matching
+// visit_ method on `Derived` directly, so there's no vtable in the way and the
+// calls can be inlined. a pass only writes the visit_ methods it cares about,
+// the rest fall through to visit_node(). whatever extra arguments visit() gets
+// are handed on as is
+template<typename Derived, typename Result = void>
+class Visitor {
+    Derived& derived(void) { return *static_cast<Derived*>(this); }
+
+    public:
+        template<typename... Args>
+        Result visit(const Ast& ast, NodeId id, Args&&... args) {
+            const Node& node = ast.get(id);
+
+            switch (node.kind) {
+
+                #define VISIT_CASE(kind, method) \
+                    case NodeKind::kind: return this->derived().method(id, node, std::forward<Args>(args)...);
+
+                NODE_KINDS(VISIT_CASE)
+
+                #undef VISIT_CASE
+
+            }
+
+            return Result();
+        }
+
+        template<typename... Args>
+        Result visit_node(NodeId, const Node&, Args&&...) {
+            return Result();
+        }
+
+        #define VISIT_DEFAULT(kind, method)                                                    \
+            template<typename... Args>                                                         \
+            Result method(NodeId id, const Node& node, Args&&... args) {                       \
+                return this->derived().visit_node(id, node, std::forward<Args>(args)...);      \
+            }
+
+        NODE_KINDS(VISIT_DEFAULT)
+
+        #undef VISIT_DEFAULT
+};
+
+#endif
@@ -1,39 +1,38 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <chrono>
 
+#include "lib/source.hpp"
 #include "lib/lexer.hpp"
 #include "lib/parser.hpp"
-#include "lib/expr.hpp"
+#include "lib/ast.hpp"
+#include "lib/serialize.hpp"
+#include "lib/sema.hpp"
+#include "lib/fold.hpp"
+#include "lib/eval.hpp"
+#include "lib/compiler.hpp"
 
 bool exists(char* name) {
     return static_cast<bool>(std::ifstream(name));
 }
 
-std::string read_file(char* file_path) {
-    std::string source = "";
-    std::string line = "";
-
-    std::ifstream source_file(file_path);
-
-    if (source_file.is_open()) {
-        while (std::getline(source_file, line)) {
-            source.append(line + "\n");
-        }
-    } else {
-        std::cout << "Unable to open \"" << file_path << "\"\n";
-        exit(1);
-    }
-    return source;
-}
-
 int main(int argc, char** argv) {
     std::string filename = "";
-    char* c_filename     = nullptr;
     bool time_comp       = false;
     bool be_quiet        = false;
     bool show_token      = false;
-    bool show_ast        = false;
+    std::string ast_as   = "";
+    bool use_mmap        = true;
+    bool use_stream      = false;
+    bool lazy_bodies     = false;
+    bool run_sema        = false;
+    bool fold            = false;
+    bool evaluate        = false;
+    size_t eval_steps    = CompileTimeEvaluator::DEFAULT_STEPS;
+    size_t eval_memory   = CompileTimeEvaluator::DEFAULT_MEMORY;
+    size_t jobs          = ThreadPool::default_size();
+    size_t max_errors    = Diagnostics::DEFAULT_LIMIT;
 
     for (int i = 1; i < argc; i++) {
         if (std::string(argv[i]) == "--timecomp") {
@@ -49,12 +48,57 @@ int main(int argc, char** argv) {
         }
 
         else if (std::string(argv[i]) == "--ast") {
-            show_ast = true;
+            ast_as = "text";
+        }
+
+        else if (std::string(argv[i]) == "--ast=compact" || std::string(argv[i]) == "--ast=binary") {
+            ast_as = std::string(argv[i]).substr(6);
+        }
+
+        else if (std::string(argv[i]) == "--no-mmap") {
+            use_mmap = false;
+        }
+
+        else if (std::string(argv[i]) == "--stream") {
+            use_stream = true;
+        }
+
+        else if (std::string(argv[i]) == "--sema") {
+            run_sema = true;
+        }
+
+        else if (std::string(argv[i]) == "--fold") {
+            fold = true;
+        }
+
+        // const initializers and #expr need names resolved, so this runs sema too
+        else if (std::string(argv[i]) == "--eval") {
+            evaluate = true;
+            run_sema = true;
+        }
+
+        else if (std::string(argv[i]) == "--eval-steps" && i + 1 < argc) {
+            eval_steps = std::max(1ll, std::atoll(argv[++i]));
+        }
+
+        else if (std::string(argv[i]) == "--eval-memory" && i + 1 < argc) {
+            eval_memory = std::max(1, std::atoi(argv[++i]));
+        }
+
+        else if (std::string(argv[i]) == "--lazy") {
+            lazy_bodies = true;
+        }
+
+        else if (std::string(argv[i]) == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        }
+
+        else if (std::string(argv[i]) == "--max-errors" && i + 1 < argc) {
+            max_errors = std::max(1, std::atoi(argv[++i]));
         }
         
-        else if (exists(argv[i])) {
+        else if (std::string(argv[i]) == "-" || exists(argv[i])) {
             filename = argv[i];
-            c_filename = argv[i];
         }
     }
     
@@ -63,39 +107,187 @@ int main(int argc, char** argv) {
         return 1;
     }
         
-    std::string source = read_file(c_filename);
+    auto load_start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<SourceFile> file = use_mmap ? SourceFile::load(filename) : SourceFile::read(filename);
+
+    if (file == nullptr) {
+        std::cout << "Unable to open \"" << filename << "\"\n";
+        return 1;
+    }
+
+    std::chrono::duration<double> load_time = std::chrono::steady_clock::now() - load_start;
+
+    if (time_comp)
+        std::cout << "[TIME]: Loaded " << file->get_contents().length() << " bytes in " << load_time.count() * 1000 << "ms\n";
+
+    uint32_t file_id = SourceManager::add(std::move(file));
 
     if (!be_quiet) 
         std::cout << "[INFO]: Successfully opened " << filename << ".\n";
 
-    Lexer* lexer = new Lexer(source, filename);
-    std::vector<std::shared_ptr<Token>> tokens = lexer->lex();
-    delete lexer;
-    
-    if (!be_quiet)
-        std::cout << "[INFO]: Successfully lexed source.\n";
+    // --token needs every token up front and --lazy has to go back to the bodies
+    // it skipped, so both always lex into a buffer
+    if (show_token || lazy_bodies)
+        use_stream = false;
+
+    Ast ast(file_id);
+    Diagnostics diagnostics(max_errors);
+
+    Lexer* lexer = new Lexer(file_id, diagnostics);
+    TokenStream tokens = TokenStream(lexer);
+
+    if (!use_stream) {
+        auto lex_start = std::chrono::steady_clock::now();
+
+        TokenBuffer buffer = ParallelLexer::lex(file_id, jobs, diagnostics);
+
+        std::chrono::duration<double> lex_time = std::chrono::steady_clock::now() - lex_start;
+
+        if (time_comp) {
+            std::cout << "[TIME]: Lexed " << buffer.size() << " tokens in " << lex_time.count() * 1000 << "ms ("
+                      << static_cast<size_t>(buffer.size() / lex_time.count()) << " tokens/sec, "
+                      << buffer.bytes_per_token() << " bytes/token)\n";
+        }
 
-    if (show_token) {
-        int amount_of_tokens = 0;
-        for (; amount_of_tokens <= tokens.size(); amount_of_tokens++) 
-            std::cout << tokens[amount_of_tokens]->lexeme << "\n";
+        if (!be_quiet && diagnostics.empty())
+            std::cout << "[INFO]: Successfully lexed source.\n";
 
-        std::cout << amount_of_tokens << "\n";
+        if (show_token) {
+            size_t amount_of_tokens = 0;
+            for (; amount_of_tokens < buffer.size(); amount_of_tokens++) 
+                std::cout << buffer.lexeme(amount_of_tokens) << "\n";
+
+            std::cout << amount_of_tokens << "\n";
+        }
+
+        ast.reserve(buffer.size());
+        tokens = TokenStream(std::move(buffer));
+    }
+
+    auto parse_start = std::chrono::steady_clock::now();
+
+    Parser* parser = new Parser(std::move(tokens), ast, diagnostics, lazy_bodies);
+    std::vector<NodeId> statements = {};
+
+    // lexer errors don't stop the parse, it can still find more. unless there are already too many
+    if (!diagnostics.full())
+        statements = parser->parse();
+
+    std::chrono::duration<double> parse_time = std::chrono::steady_clock::now() - parse_start;
+
+    if (time_comp)
+        std::cout << "[TIME]: Parsed " << (use_stream ? "(streaming) " : "") << "in " << parse_time.count() * 1000 << "ms ("
+                  << ast.size() << " nodes, " << ast.bytes() / 1024 << "KB of AST"
+                  << (lazy_bodies ? ", " + std::to_string(parser->lazy_count()) + " bodies skipped" : "") << ")\n";
+
+    // only writing the AST out, folding and sema need the bodies, and only then are their syntax errors found
+    if (lazy_bodies && (ast_as != "" || fold || run_sema) && !diagnostics.full()) {
+        auto bodies_start = std::chrono::steady_clock::now();
+
+        parser->parse_bodies();
+
+        std::chrono::duration<double> bodies_time = std::chrono::steady_clock::now() - bodies_start;
+
+        if (time_comp)
+            std::cout << "[TIME]: Parsed " << parser->lazy_count() << " function bodies in " << bodies_time.count() * 1000 << "ms ("
+                      << ast.size() << " nodes)\n";
     }
 
-    Parser* parser = new Parser(tokens, filename);
-    std::vector<std::shared_ptr<Stmt::Stmt>> statements = parser->parse();
     delete parser;
+    delete lexer;
+
+    if (!diagnostics.empty()) {
+        diagnostics.print();
+        return 1;
+    }
     
     if (!be_quiet)
         std::cout << "[INFO]: Successfully parsed source.\n";
 
-    if (show_ast) {
-        for (const std::shared_ptr<Stmt::Stmt> statement : statements) {
-            statement->print();
-            std::cout << "\n";
+    if (fold) {
+        auto fold_start = std::chrono::steady_clock::now();
+
+        ConstantFolder folder(ast);
+        folder.fold_all(statements);
+
+        std::chrono::duration<double> fold_time = std::chrono::steady_clock::now() - fold_start;
+
+        if (time_comp)
+            std::cout << "[TIME]: Folded " << folder.folded_count() << " expressions in " << fold_time.count() * 1000 << "ms\n";
+
+        if (!be_quiet)
+            std::cout << "[INFO]: Successfully folded constants.\n";
+    }
+
+    if (run_sema) {
+        auto sema_start = std::chrono::steady_clock::now();
+
+        SemaAnalyser sema(ast, statements, diagnostics, jobs);
+        sema.begin_analysis();
+
+        std::chrono::duration<double> sema_time = std::chrono::steady_clock::now() - sema_start;
+
+        if (time_comp)
+            std::cout << "[TIME]: Resolved " << sema.resolved_uses() << " names (" << sema.body_count() << " bodies on " << jobs << " threads) in " << sema_time.count() * 1000 << "ms\n";
+
+        if (!diagnostics.empty()) {
+            diagnostics.print();
+            return 1;
+        }
+
+        if (!be_quiet)
+            std::cout << "[INFO]: Successfully resolved names.\n";
+
+        if (evaluate) {
+            auto eval_start = std::chrono::steady_clock::now();
+
+            CompileTimeEvaluator evaluator(ast, sema, diagnostics, eval_steps, eval_memory);
+            evaluator.evaluate_all(statements);
+
+            std::chrono::duration<double> eval_time = std::chrono::steady_clock::now() - eval_start;
+
+            if (time_comp)
+                std::cout << "[TIME]: Evaluated " << evaluator.evaluated_count() << " constants (" << evaluator.step_count() << " steps) in "
+                          << eval_time.count() * 1000 << "ms\n";
+
+            if (!diagnostics.empty()) {
+                diagnostics.print();
+                return 1;
+            }
+
+            if (!be_quiet)
+                std::cout << "[INFO]: Successfully evaluated constants.\n";
         }
-        std::cout << statements.size() << "\n";
+    }
+
+    if (ast_as != "") {
+        auto write_start = std::chrono::steady_clock::now();
+
+        Output out(stdout);
+        AstWriter writer(ast, out);
+
+        if (ast_as == "binary") {
+            writer.binary(statements);
+        } else {
+            for (NodeId statement : statements) {
+                if (ast_as == "compact")
+                    writer.compact(statement);
+                else
+                    writer.text(statement);
+                out.put('\n');
+            }
+
+            out.number(static_cast<uint64_t>(statements.size()));
+            out.put('\n');
+        }
+
+        out.flush();
+
+        std::chrono::duration<double> write_time = std::chrono::steady_clock::now() - write_start;
+
+        if (time_comp)
+            std::cout << "[TIME]: Wrote the AST in " << write_time.count() * 1000 << "ms\n";
     }
 
     return 0;